@@ -0,0 +1,100 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Compile-time benchmark. It's the build, not the run, that is measured
+ * here: the file instantiates static_ptr machinery for a large number of
+ * product types the way a big codebase does - emplacing each product,
+ * moving it between a few variants of static_ptr and dispatching through
+ * a factory. Track the compilation time and the size of the object file:
+ *
+ *     time g++ -O2 -std=c++17 -I. -c benchmarks/compile_time_bench.cc
+ *     size compile_time_bench.o
+ *
+ * The number of products is STATIC_PTR_BENCH_PRODUCTS (1000 by default);
+ * comparing two counts separates the per-product cost from the constant
+ * one. */
+
+#include <cstddef>
+#include <utility>
+
+#include "static_factory.hpp"
+
+#ifndef STATIC_PTR_BENCH_PRODUCTS
+#define STATIC_PTR_BENCH_PRODUCTS 1000
+#endif
+
+
+struct Interface {
+  virtual ~Interface() {}
+  virtual size_t get() const = 0;
+};
+
+/* Products differ in size, so they spread over several variants. */
+template <size_t N>
+struct Product : public Interface {
+  unsigned char payload[1 + N % 64];
+
+  explicit Product(size_t seed) {
+    payload[0] = static_cast<unsigned char>(seed + N);
+  }
+
+  size_t get() const override {
+    return payload[0];
+  }
+};
+
+typedef static_ptr<Interface, 128> big_ptr;
+
+template <size_t N>
+size_t exercise(size_t seed) {
+  static_ptr<Interface, sizeof(Product<N>)> small(
+    std::in_place_type<Product<N>>, seed);
+  big_ptr big(std::move(small));
+  big_ptr other;
+  other = std::move(big);
+  return other->get();
+}
+
+template <size_t... N>
+size_t exercise_all(size_t seed, std::index_sequence<N...>) {
+  /* Not a fold expression: compilers limit the nesting of those. */
+  const size_t results[] = { exercise<N>(seed)... };
+  size_t sum = 0;
+  for (size_t result : results) {
+    sum += result;
+  }
+  return sum;
+}
+
+/* A factory over a slice of the products. Building it for all of them
+ * would measure mostly the compiler's handling of long parameter packs. */
+template <size_t... N>
+size_t make_all(size_t seed, std::index_sequence<N...>) {
+  typedef static_factory<Interface, Product<N>...> Factory;
+  size_t sum = 0;
+  for (size_t tag = 0; tag < Factory::product_count; tag++) {
+    sum += Factory::make(tag, seed)->get();
+  }
+  return sum;
+}
+
+int main(int argc, char**) {
+  const size_t seed = static_cast<size_t>(argc);
+  return static_cast<int>(
+    exercise_all(seed,
+                 std::make_index_sequence<STATIC_PTR_BENCH_PRODUCTS>()) +
+    make_all(seed, std::make_index_sequence<64>()));
+}
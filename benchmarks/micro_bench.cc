@@ -0,0 +1,431 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Microbenchmarks comparing static_ptr with std::unique_ptr, std::variant
+ * and std::any, and static_function with std::function. Every scenario is
+ * run across a few product sizes and thread counts. Next to the time per
+ * operation the number of heap allocations per operation is reported, and
+ * the whole run fails if any of the static_ptr scenarios has allocated -
+ * the "zero allocations" promise is a part of the contract.
+ *
+ * The file is self-contained; building it needs nothing but C++17:
+ *
+ *     g++ -O2 -std=c++17 -pthread -I. benchmarks/micro_bench.cc
+ */
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "static_factory.hpp"
+#include "static_function.hpp"
+
+
+/* Counting allocations is done by replacing the global operator new. The
+ * counter is per-thread, so allocations made by the harness itself (e.g.
+ * for spawning threads) don't interfere. The replacements are never inlined
+ * to not confuse GCC's new/delete mismatch detection. */
+static thread_local unsigned long allocations = 0;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+  allocations++;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+
+template <class T>
+static inline void do_not_optimize(T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+
+struct Interface {
+  virtual unsigned long value() const = 0;
+};
+
+template <size_t Size>
+struct ProductA : public Interface {
+  unsigned char payload[Size];
+  explicit ProductA(unsigned i) { payload[0] = i; }
+  unsigned long value() const override { return payload[0]; }
+};
+
+template <size_t Size>
+struct ProductB : public Interface {
+  unsigned char payload[Size];
+  explicit ProductB(unsigned i) { payload[0] = i + 1; }
+  unsigned long value() const override { return payload[0] * 2; }
+};
+
+
+/* Each kind of holder is described by a policy offering the same set of
+ * operations, so all scenarios can be written once. */
+template <size_t Size>
+struct static_ptr_kind {
+  static constexpr const char* name = "static_ptr";
+  static constexpr bool must_not_allocate = true;
+
+  typedef static_factory<Interface, ProductA<Size>, ProductB<Size>> factory;
+  typedef typename factory::pointer holder;
+
+  static holder make(unsigned i) {
+    return factory::make(i & 1, i);
+  }
+
+  static unsigned long call(const holder& h) {
+    return h->value();
+  }
+
+  /* Hop through bigger and bigger variants of static_ptr. */
+  static unsigned long move_chain(holder&& h) {
+    static_ptr<Interface, 2 * holder::element_max_size> h2 = std::move(h);
+    static_ptr<Interface, 4 * holder::element_max_size> h4 = std::move(h2);
+    static_ptr<Interface, 4 * holder::element_max_size> h4b;
+    h4b = std::move(h4);
+    return h4b->value();
+  }
+};
+
+template <size_t Size>
+struct unique_ptr_kind {
+  static constexpr const char* name = "unique_ptr";
+  static constexpr bool must_not_allocate = false;
+
+  typedef std::unique_ptr<Interface> holder;
+
+  static holder make(unsigned i) {
+    if (i & 1) {
+      return std::make_unique<ProductB<Size>>(i);
+    } else {
+      return std::make_unique<ProductA<Size>>(i);
+    }
+  }
+
+  static unsigned long call(const holder& h) {
+    return h->value();
+  }
+
+  static unsigned long move_chain(holder&& h) {
+    holder h2 = std::move(h);
+    holder h4 = std::move(h2);
+    holder h4b;
+    h4b = std::move(h4);
+    return h4b->value();
+  }
+};
+
+template <size_t Size>
+struct variant_kind {
+  static constexpr const char* name = "std::variant";
+  static constexpr bool must_not_allocate = false;
+
+  typedef std::variant<ProductA<Size>, ProductB<Size>> holder;
+
+  static holder make(unsigned i) {
+    if (i & 1) {
+      return holder(std::in_place_type<ProductB<Size>>, i);
+    } else {
+      return holder(std::in_place_type<ProductA<Size>>, i);
+    }
+  }
+
+  static unsigned long call(const holder& h) {
+    return std::visit([](const auto& p) { return p.value(); }, h);
+  }
+
+  static unsigned long move_chain(holder&& h) {
+    holder h2 = std::move(h);
+    holder h4 = std::move(h2);
+    holder h4b { std::in_place_index<0>, 0u };
+    h4b = std::move(h4);
+    return call(h4b);
+  }
+};
+
+template <size_t Size>
+struct any_kind {
+  static constexpr const char* name = "std::any";
+  static constexpr bool must_not_allocate = false;
+
+  typedef std::any holder;
+
+  static holder make(unsigned i) {
+    if (i & 1) {
+      return holder(std::in_place_type<ProductB<Size>>, i);
+    } else {
+      return holder(std::in_place_type<ProductA<Size>>, i);
+    }
+  }
+
+  static unsigned long call(const holder& h) {
+    if (auto a = std::any_cast<ProductA<Size>>(&h)) {
+      return a->value();
+    }
+    return std::any_cast<ProductB<Size>>(&h)->value();
+  }
+
+  static unsigned long move_chain(holder&& h) {
+    holder h2 = std::move(h);
+    holder h4 = std::move(h2);
+    holder h4b;
+    h4b = std::move(h4);
+    return call(h4b);
+  }
+};
+
+/* The callable holders carry the product in the closure and call it through
+ * the holder's own dispatch instead of the product's virtual method. */
+template <class Holder, size_t Size>
+static Holder make_callable(unsigned i) {
+  if (i & 1) {
+    return Holder([p = ProductB<Size>(i)] { return p.value(); });
+  } else {
+    return Holder([p = ProductA<Size>(i)] { return p.value(); });
+  }
+}
+
+template <size_t Size>
+struct function_kind {
+  static constexpr const char* name = "std::function";
+  static constexpr bool must_not_allocate = false;
+
+  typedef std::function<unsigned long()> holder;
+
+  static holder make(unsigned i) {
+    return make_callable<holder, Size>(i);
+  }
+
+  static unsigned long call(const holder& h) {
+    return h();
+  }
+
+  static unsigned long move_chain(holder&& h) {
+    holder h2 = std::move(h);
+    holder h4 = std::move(h2);
+    holder h4b;
+    h4b = std::move(h4);
+    return h4b();
+  }
+};
+
+template <size_t Size>
+struct static_function_kind {
+  static constexpr const char* name = "static_function";
+  static constexpr bool must_not_allocate = true;
+
+  typedef static_function<unsigned long(), sizeof(ProductB<Size>)> holder;
+
+  static holder make(unsigned i) {
+    return make_callable<holder, Size>(i);
+  }
+
+  static unsigned long call(const holder& h) {
+    return h();
+  }
+
+  /* Hop through bigger and bigger variants, as for static_ptr. */
+  static unsigned long move_chain(holder&& h) {
+    static_function<unsigned long(), 2 * holder::element_max_size> h2 =
+      std::move(h);
+    static_function<unsigned long(), 4 * holder::element_max_size> h4 =
+      std::move(h2);
+    static_function<unsigned long(), 4 * holder::element_max_size> h4b;
+    h4b = std::move(h4);
+    return h4b();
+  }
+};
+
+
+/* The scenarios. Each one performs `iters` operations. */
+template <class Kind>
+struct scenarios {
+  typedef typename Kind::holder holder;
+
+  static void construct_destroy(size_t iters) {
+    for (size_t i = 0; i < iters; i++) {
+      holder h = Kind::make(i);
+      do_not_optimize(h);
+    }
+  }
+
+  static void move_chain(size_t iters) {
+    unsigned long sum = 0;
+    for (size_t i = 0; i < iters; i++) {
+      sum += Kind::move_chain(Kind::make(i));
+    }
+    do_not_optimize(sum);
+  }
+
+  static void dispatch(size_t iters) {
+    static constexpr size_t pool_size = 1024;
+    std::vector<holder> pool;
+    pool.reserve(pool_size);
+    for (size_t i = 0; i < pool_size; i++) {
+      /* Pseudo-random (but deterministic) mix of concrete types. */
+      pool.push_back(Kind::make((i * 2654435761u) >> 7));
+    }
+
+    unsigned long sum = 0;
+    for (size_t i = 0; i < iters; i++) {
+      sum += Kind::call(pool[i % pool_size]);
+    }
+    do_not_optimize(sum);
+  }
+
+  static void container(size_t iters) {
+    static constexpr size_t depth = 64;
+    std::vector<holder> queue;
+    queue.reserve(depth);
+    for (size_t i = 0; i < iters; i += depth) {
+      for (size_t j = 0; j < depth; j++) {
+        queue.push_back(Kind::make(i + j));
+      }
+      while (!queue.empty()) {
+        queue.pop_back();
+      }
+    }
+  }
+};
+
+
+struct result {
+  double ns_per_op;
+  double allocs_per_op;
+};
+
+/* Run the scenario on the given number of threads at once. The time is
+ * averaged over threads, the allocations are counted for all of them. */
+template <class Scenario>
+static result run(Scenario scenario, unsigned threads, size_t iters) {
+  std::atomic<unsigned> ready { 0 };
+  std::atomic<bool> go { false };
+  std::vector<double> elapsed_ns(threads);
+  std::vector<unsigned long> allocated(threads);
+  std::vector<std::thread> workers;
+
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      ready++;
+      while (!go.load()) {
+      }
+      const unsigned long allocations_before = allocations;
+      const auto start = std::chrono::steady_clock::now();
+      scenario(iters);
+      const auto stop = std::chrono::steady_clock::now();
+      allocated[t] = allocations - allocations_before;
+      elapsed_ns[t] =
+        std::chrono::duration<double, std::nano>(stop - start).count();
+    });
+  }
+  while (ready.load() != threads) {
+  }
+  go = true;
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  double total_ns = 0;
+  unsigned long total_allocated = 0;
+  for (unsigned t = 0; t < threads; t++) {
+    total_ns += elapsed_ns[t];
+    total_allocated += allocated[t];
+  }
+  return result { total_ns / threads / iters,
+                  static_cast<double>(total_allocated) / (threads * iters) };
+}
+
+static bool failed = false;
+
+template <class Kind>
+static void run_kind(size_t size, unsigned threads, size_t iters) {
+  typedef scenarios<Kind> s;
+  const struct {
+    const char* name;
+    void (*fn)(size_t);
+    bool setup_allocates;
+  } table[] = {
+    { "construct+destroy", &s::construct_destroy, false },
+    { "move chain",        &s::move_chain,        false },
+    { "dispatch",          &s::dispatch,          true  },
+    { "container",         &s::container,         true  },
+  };
+
+  for (const auto& entry : table) {
+    const result r = run(entry.fn, threads, iters);
+    std::printf("%-18s %-15s %6zu %8u %12.2f %12.4f\n",
+                entry.name, Kind::name, size, threads,
+                r.ns_per_op, r.allocs_per_op);
+
+    /* The dispatch and container scenarios allocate their std::vector during
+     * setup. It's amortized over iters and must stay way below one. */
+    const double limit = entry.setup_allocates ? 0.01 : 0.0;
+    if (Kind::must_not_allocate && r.allocs_per_op > limit) {
+      std::printf("FAILED: %s allocated in \"%s\"\n", Kind::name, entry.name);
+      failed = true;
+    }
+  }
+}
+
+template <size_t Size>
+static void run_size(unsigned threads, size_t iters) {
+  run_kind<static_ptr_kind<Size>>(Size, threads, iters);
+  run_kind<unique_ptr_kind<Size>>(Size, threads, iters);
+  run_kind<variant_kind<Size>>(Size, threads, iters);
+  run_kind<any_kind<Size>>(Size, threads, iters);
+  run_kind<function_kind<Size>>(Size, threads, iters);
+  run_kind<static_function_kind<Size>>(Size, threads, iters);
+}
+
+
+int main(int argc, char** argv) {
+  const size_t iters = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                : 1000000;
+
+  std::vector<unsigned> thread_counts { 1, 2, 4 };
+  thread_counts.push_back(std::max(1u, std::thread::hardware_concurrency()));
+  std::sort(thread_counts.begin(), thread_counts.end());
+  thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()),
+                      thread_counts.end());
+
+  std::printf("%-18s %-15s %6s %8s %12s %12s\n",
+              "scenario", "holder", "size", "threads", "ns/op", "allocs/op");
+  for (unsigned threads : thread_counts) {
+    run_size<8>(threads, iters);
+    run_size<64>(threads, iters);
+    run_size<256>(threads, iters);
+  }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
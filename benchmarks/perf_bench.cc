@@ -0,0 +1,423 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Hardware-counter benchmarks of the paths where static_ptr spends its
+ * cycles: the virtual dispatch behind operator->, the LCM calls of moves
+ * and destruction, and the cache footprint of MaxSize. Scripted workloads
+ * are run under Linux perf_event counters and reported per operation:
+ * IPC, cycles, branch misses, L1D and LLC read misses.
+ *
+ * Results can be stored as a baseline and later runs compared against it;
+ * a regression beyond the tolerance fails the run. Typical use:
+ *
+ *     g++ -O2 -std=c++17 -I. benchmarks/perf_bench.cc -o perf_bench
+ *     ./perf_bench --save baseline.txt
+ *     ... change things ...
+ *     ./perf_bench --baseline baseline.txt [--tolerance 0.1]
+ *
+ * Exit codes: 0 - fine, 1 - regression, 77 - no counters available (e.g.
+ * perf_event_paranoid or a container forbids them), so CI can tell
+ * "skipped" from "passed". Counters the CPU lacks are reported as "-" and
+ * not compared. */
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "static_factory.hpp"
+#include "static_ptr_algorithm.hpp"
+#include "static_ring.hpp"
+
+
+template <class T>
+static inline void do_not_optimize(T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+
+/* The counters. Each event is opened on its own, not as a group, so
+ * a missing one doesn't take the others down; the kernel's multiplexing is
+ * compensated with the enabled/running times. */
+struct counter_spec {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+};
+
+static constexpr uint64_t cache_event(uint64_t cache, uint64_t op,
+                                      uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+static const counter_spec counter_specs[] = {
+  { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { "l1d-misses", PERF_TYPE_HW_CACHE,
+    cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_MISS) },
+  { "llc-misses", PERF_TYPE_HW_CACHE,
+    cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_MISS) },
+};
+
+static constexpr size_t counter_count =
+  sizeof(counter_specs) / sizeof(counter_specs[0]);
+
+class counters {
+  int fds[counter_count];
+
+public:
+  counters() {
+    for (size_t i = 0; i < counter_count; i++) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = counter_specs[i].type;
+      attr.config = counter_specs[i].config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fds[i] = static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+  }
+
+  counters(const counters&) = delete;
+  counters& operator=(const counters&) = delete;
+
+  ~counters() {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  bool any() const {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void start() {
+    for (int fd : fds) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+
+  /* Negative values mark counters that are unavailable. */
+  void stop(double (&values)[counter_count]) {
+    for (size_t i = 0; i < counter_count; i++) {
+      values[i] = -1;
+      if (fds[i] < 0) {
+        continue;
+      }
+      ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+      uint64_t data[3];
+      if (read(fds[i], data, sizeof(data)) == sizeof(data) && data[2]) {
+        values[i] = static_cast<double>(data[0]) *
+                    static_cast<double>(data[1]) /
+                    static_cast<double>(data[2]);
+      }
+    }
+  }
+};
+
+
+/* Products of a few sizes, so the mix exercises both the dispatch and the
+ * footprint of MaxSize. */
+struct Interface {
+  virtual ~Interface() {}
+  virtual unsigned long value() const = 0;
+};
+
+template <size_t Size, unsigned Mul>
+struct Product final : public Interface {
+  unsigned char payload[Size];
+
+  explicit Product(unsigned i) noexcept {
+    payload[0] = static_cast<unsigned char>(i);
+  }
+
+  unsigned long value() const override {
+    return payload[0] * Mul;
+  }
+};
+
+typedef Product<8, 1> ProductA;
+typedef Product<24, 3> ProductB;
+typedef Product<48, 5> ProductC;
+typedef Product<96, 7> ProductD;
+
+typedef static_factory<Interface, ProductA, ProductB, ProductC, ProductD>
+  factory;
+typedef factory::pointer pointer;
+
+/* Deterministic pseudo-random tags; a fixed pattern would be learnt by the
+ * branch predictors and hide the dispatch costs. */
+static inline unsigned next_tag(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 30;
+}
+
+
+/* The workloads. Each returns the number of operations it has done. */
+static size_t factory_stream(size_t iters) {
+  uint32_t state = 1;
+  unsigned long sum = 0;
+  for (size_t i = 0; i < iters; i++) {
+    pointer ptr = factory::make(next_tag(state), static_cast<unsigned>(i));
+    sum += ptr->value();
+  }
+  do_not_optimize(sum);
+  return iters;
+}
+
+static size_t move_chain(size_t iters) {
+  uint32_t state = 2;
+  unsigned long sum = 0;
+  for (size_t i = 0; i < iters; i++) {
+    pointer ptr = factory::make(next_tag(state), static_cast<unsigned>(i));
+    static_ptr<Interface, 2 * pointer::element_max_size> bigger =
+      std::move(ptr);
+    static_ptr<Interface, 2 * pointer::element_max_size> other;
+    other = std::move(bigger);
+    sum += other->value();
+  }
+  do_not_optimize(sum);
+  return iters;
+}
+
+static size_t queue_handoff(size_t iters) {
+  static constexpr size_t batch = 64;
+  typedef static_ring<Interface, pointer::element_max_size, 256> ring_t;
+  static ring_t ring;
+
+  uint32_t state = 3;
+  unsigned long sum = 0;
+  ring_t::slot_type out;
+  for (size_t i = 0; i < iters; i += batch) {
+    for (size_t j = 0; j < batch; j++) {
+      const unsigned n = static_cast<unsigned>(i + j);
+      switch (next_tag(state)) {
+      case 0: ring.try_emplace<ProductA>(n); break;
+      case 1: ring.try_emplace<ProductB>(n); break;
+      case 2: ring.try_emplace<ProductC>(n); break;
+      default: ring.try_emplace<ProductD>(n); break;
+      }
+    }
+    while (ring.try_pop(out)) {
+      sum += out->value();
+      out.reset();
+    }
+  }
+  do_not_optimize(sum);
+  return iters;
+}
+
+static size_t array_teardown(size_t iters) {
+  static constexpr size_t length = 1024;
+  static pointer array[length];
+
+  uint32_t state = 4;
+  for (size_t i = 0; i < iters; i += length) {
+    for (size_t j = 0; j < length; j++) {
+      array[j] = factory::make(next_tag(state), static_cast<unsigned>(j));
+    }
+    destroy_n(array, length);
+  }
+  return iters;
+}
+
+
+struct workload {
+  const char* name;
+  size_t (*fn)(size_t);
+};
+
+static const workload workloads[] = {
+  { "factory_stream", &factory_stream },
+  { "move_chain", &move_chain },
+  { "queue_handoff", &queue_handoff },
+  { "array_teardown", &array_teardown },
+};
+
+/* Metrics per operation, by name. IPC is the only one where more is
+ * better. */
+typedef std::map<std::string, double> metrics;
+
+static metrics measure(counters& cnt, const workload& w, size_t iters) {
+  /* Warm up the caches and the predictors first. */
+  w.fn(iters / 10);
+
+  double values[counter_count];
+  cnt.start();
+  const size_t ops = w.fn(iters);
+  cnt.stop(values);
+
+  metrics m;
+  for (size_t i = 0; i < counter_count; i++) {
+    if (values[i] >= 0) {
+      m[counter_specs[i].name] = values[i] / ops;
+    }
+  }
+  if (values[0] > 0 && values[1] >= 0) {
+    m["ipc"] = values[1] / values[0];
+  }
+  return m;
+}
+
+static std::map<std::string, metrics> load_baseline(const char* path) {
+  std::map<std::string, metrics> baseline;
+  if (FILE* f = std::fopen(path, "r")) {
+    char name[64], metric[64];
+    double value;
+    while (std::fscanf(f, "%63s %63s %lf", name, metric, &value) == 3) {
+      baseline[name][metric] = value;
+    }
+    std::fclose(f);
+  } else {
+    std::fprintf(stderr, "can't read baseline %s\n", path);
+    std::exit(EXIT_FAILURE);
+  }
+  return baseline;
+}
+
+/* Tiny per-op values (e.g. LLC misses) are dominated by noise. Changes
+ * below the absolute slack aren't regressions however big they're
+ * relatively. */
+static constexpr double absolute_slack = 0.01;
+
+static bool regressed(const std::string& metric, double value, double base,
+                      double tolerance) {
+  if (metric == "ipc") {
+    return value < base * (1 - tolerance) - absolute_slack;
+  }
+  return value > base * (1 + tolerance) + absolute_slack;
+}
+
+int main(int argc, char** argv) {
+  size_t iters = 1000000;
+  const char* baseline_path = nullptr;
+  const char* save_path = nullptr;
+  double tolerance = 0.10;
+
+  for (int i = 1; i < argc; i++) {
+    const bool has_value = i + 1 < argc;
+    if (!std::strcmp(argv[i], "--iters") && has_value) {
+      iters = std::strtoul(argv[++i], nullptr, 10);
+    } else if (!std::strcmp(argv[i], "--baseline") && has_value) {
+      baseline_path = argv[++i];
+    } else if (!std::strcmp(argv[i], "--save") && has_value) {
+      save_path = argv[++i];
+    } else if (!std::strcmp(argv[i], "--tolerance") && has_value) {
+      tolerance = std::strtod(argv[++i], nullptr);
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--iters N] [--save FILE] "
+                   "[--baseline FILE [--tolerance T]]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  counters cnt;
+  if (!cnt.any()) {
+    std::fprintf(stderr, "perf_event counters unavailable; skipping\n");
+    return 77;
+  }
+
+  std::map<std::string, metrics> baseline;
+  if (baseline_path) {
+    baseline = load_baseline(baseline_path);
+  }
+
+  FILE* save = nullptr;
+  if (save_path && !(save = std::fopen(save_path, "w"))) {
+    std::fprintf(stderr, "can't write baseline %s\n", save_path);
+    return EXIT_FAILURE;
+  }
+
+  static const char* const columns[] = {
+    "ipc", "cycles", "branch-misses", "l1d-misses", "llc-misses"
+  };
+
+  std::printf("%-16s", "workload");
+  for (const char* column : columns) {
+    std::printf(" %14s", column);
+  }
+  std::printf("\n");
+
+  bool failed = false;
+  for (const workload& w : workloads) {
+    const metrics m = measure(cnt, w, iters);
+
+    std::printf("%-16s", w.name);
+    for (const char* column : columns) {
+      const auto it = m.find(column);
+      if (it == m.end()) {
+        std::printf(" %14s", "-");
+      } else {
+        std::printf(" %14.4f", it->second);
+      }
+    }
+    std::printf("\n");
+
+    for (const auto& entry : m) {
+      if (save) {
+        std::fprintf(save, "%s %s %.6f\n",
+                     w.name, entry.first.c_str(), entry.second);
+      }
+
+      const auto base = baseline.find(w.name);
+      if (base == baseline.end()) {
+        continue;
+      }
+      const auto base_value = base->second.find(entry.first);
+      if (base_value != base->second.end() &&
+          regressed(entry.first, entry.second, base_value->second,
+                    tolerance)) {
+        std::printf("REGRESSION: %s %s %.4f (baseline %.4f)\n",
+                    w.name, entry.first.c_str(), entry.second,
+                    base_value->second);
+        failed = true;
+      }
+    }
+  }
+
+  if (save) {
+    std::fclose(save);
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
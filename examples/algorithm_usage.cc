@@ -0,0 +1,142 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* The batch algorithms of static_ptr_algorithm.hpp over an array of
+ * static_ptr mixing relocatable and non-relocatable products with empty
+ * pointers in between. The program checks that every product lands where
+ * it should, exactly once, and fails if anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/algorithm_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "static_ptr_algorithm.hpp"
+
+static long alive = 0;
+static long moves = 0;
+
+struct Item {
+  long id;
+  explicit Item(long id) : id(id) { alive++; }
+  Item(Item&& rhs) : id(rhs.id) { alive++; moves++; }
+  virtual ~Item() { alive--; }
+};
+
+/* Moved by the runs with a single memmove. */
+struct Plain : public Item {
+  explicit Plain(long id) : Item(id) {}
+};
+
+template <>
+struct is_trivially_relocatable<Plain> : std::true_type {};
+
+/* Moved through the LCM, element by element. */
+struct Named : public Item {
+  std::string name;
+  explicit Named(long id) : Item(id), name(std::to_string(id)) {}
+};
+
+typedef static_ptr<Item, maxsizeof<Plain, Named>()> Ptr;
+
+static const size_t count = 12;
+
+/* Runs of Plains, Nameds and empty pointers: P P P N N _ P N N N _ P. */
+static void fill(Ptr* ptrs) {
+  const char* const layout = "PPPNN_PNNN_P";
+  for (size_t i = 0; i < count; i++) {
+    if (layout[i] == 'P') {
+      ptrs[i].emplace<Plain>(static_cast<long>(i));
+    } else if (layout[i] == 'N') {
+      ptrs[i].emplace<Named>(static_cast<long>(i));
+    }
+  }
+}
+
+/* Every pointer holds the product filled in at its index, or is empty where
+ * fill left it so. */
+static bool holds_layout(const Ptr* ptrs) {
+  const char* const layout = "PPPNN_PNNN_P";
+  for (size_t i = 0; i < count; i++) {
+    if ((layout[i] == '_') != !ptrs[i].get() ||
+        (ptrs[i].get() && ptrs[i]->id != static_cast<long>(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool all_empty(const Ptr* ptrs) {
+  for (size_t i = 0; i < count; i++) {
+    if (ptrs[i].get()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+
+int main (void) {
+  {
+    Ptr src[count], dst[count];
+    fill(src);
+
+    /* Only the five Nameds go through their move constructor. */
+    relocate_n(src, count, dst);
+    expect(holds_layout(dst) && all_empty(src) && moves == 5,
+           "relocate_n between two arrays");
+
+    /* Overlapping ranges: shift everything by one to the front. */
+    Ptr shifted[count + 1];
+    relocate_n(dst, count, shifted + 1);
+    relocate_n(shifted + 1, count, shifted);
+    expect(holds_layout(shifted) && !shifted[count].get(),
+           "overlapping relocate_n");
+
+    /* Into raw memory. */
+    alignas(Ptr) unsigned char raw[count * sizeof(Ptr)];
+    Ptr* const constructed = reinterpret_cast<Ptr*>(raw);
+    Ptr* const end = uninitialized_move_n(shifted, count, constructed);
+    expect(end == constructed + count && holds_layout(constructed) &&
+             all_empty(shifted),
+           "uninitialized_move_n");
+
+    /* Destroys the objects, the pointers themselves stay. */
+    destroy_n(constructed, count);
+    expect(alive == 0 && all_empty(constructed), "destroy_n");
+    for (Ptr* p = constructed; p != end; p++) {
+      p->~Ptr();
+    }
+
+    /* Result: moves through the LCM: 20 */
+    std::cout << "moves through the LCM: " << moves << std::endl;
+  }
+
+  expect(alive == 0, "no product leaked");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_any holding unrelated types in one fixed-size slot. The program
+ * checks any_cast with all kinds of cv- and reference qualifiers, moves
+ * between capacities and the failure cases, and fails if anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/any_usage.cc
+ */
+
+#include <any>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "static_any.hpp"
+
+struct Base {
+  int id = 1;
+};
+
+struct Derived : public Base {
+};
+
+typedef static_any<sizeof(std::string)> Any;
+typedef static_any<2 * sizeof(std::string)> BigAny;
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+template <class T, class A>
+static bool throws_bad_cast(A&& any) {
+  try {
+    any_cast<T>(std::forward<A>(any));
+  } catch (const std::bad_any_cast&) {
+    return true;
+  }
+  return false;
+}
+
+
+int main (void) {
+  Any value(42);
+  expect(value.holds<int>() && !value.holds<long>(), "holds the int");
+
+  /* cv-qualifiers don't matter, the type must match exactly otherwise. */
+  expect(any_cast<int>(&value) && any_cast<const int>(&value) &&
+           any_cast<volatile int>(&value) && !any_cast<long>(&value) &&
+           !any_cast<unsigned>(&value),
+           "pointer casts");
+
+  /* References give access to the held value itself. */
+  any_cast<int&>(value) = 7;
+  expect(*any_cast<const int>(&value) == 7, "modified through int&");
+
+  const Any& view = value;
+  expect(any_cast<const int&>(view) == 7 && any_cast<int>(view) == 7 &&
+           *any_cast<int>(&view) == 7,
+           "casts of a const static_any");
+
+  /* Mismatches throw. */
+  expect(throws_bad_cast<long>(value) && throws_bad_cast<const long&>(view),
+         "mismatches throw");
+
+  /* No conversions to bases either, as with std::any. */
+  Any derived(Derived {});
+  expect(any_cast<Derived>(&derived) && !any_cast<Base>(&derived) &&
+           throws_bad_cast<Base&>(derived),
+         "no casts to a base");
+
+  /* Moving out of an rvalue leaves the value moved-from in place. */
+  static const char* const long_text =
+    "a string long enough to live on the heap";
+  Any text(std::in_place_type<std::string>, long_text);
+  const std::string moved = any_cast<std::string>(std::move(text));
+  expect(moved == long_text && text.holds<std::string>(),
+         "moved out of an rvalue");
+
+  /* A smaller static_any moves into a bigger one. */
+  BigAny big(std::move(value));
+  expect(!value.has_value() && any_cast<int>(big) == 7,
+         "moved into a bigger static_any");
+
+  big.emplace<std::string>(moved);
+  expect(any_cast<const std::string&>(big) == moved, "emplaced a string");
+  big.reset();
+  expect(!big.has_value() && !any_cast<int>(&big) &&
+           big.type_id() == nullptr,
+           "empty after reset");
+
+  /* Result: moved out: a string long enough to live on the heap */
+  std::cout << "moved out: " << moved << std::endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_arena holding the state of a request: products of different sizes
+ * bump-allocated in one inline buffer. The program checks the order of
+ * iteration and destruction and how the space is used, and fails if
+ * anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/arena_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "static_arena.hpp"
+
+struct Step {
+  /* NOTE: the destructor is NOT virtual. */
+  virtual char name() const = 0;
+};
+
+/* Remembers the order of destruction. */
+static std::string destroyed;
+
+struct Tracked : public Step {
+  char id;
+  long payload[8];
+  explicit Tracked(char id) : id(id), payload{} {}
+  ~Tracked() { destroyed += id; }
+  char name() const override { return id; }
+};
+
+/* Trivially destructible: arenas holding just these reset in O(1). */
+struct Flag : public Step {
+  char id;
+  explicit Flag(char id) : id(id) {}
+  char name() const override { return id; }
+};
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+template <class Arena>
+static std::string names(const Arena& arena, bool reverse) {
+  std::string result;
+  auto append = [&](const Step& step) { result += step.name(); };
+  if (reverse) {
+    arena.for_each_reverse(append);
+  } else {
+    arena.for_each(append);
+  }
+  return result;
+}
+
+
+int main (void) {
+  {
+    static_arena<Step, 512> arena;
+    arena.emplace<Tracked>('a');
+    arena.emplace<Flag>('b');
+    Tracked* const c = arena.emplace<Tracked>('c');
+    arena.emplace<Flag>('d');
+
+    expect(arena.size() == 4 && names(arena, false) == "abcd" &&
+             names(arena, true) == "dcba",
+           "iteration in both directions");
+
+    /* Flags take far less than Trackeds, not the size of the biggest. */
+    expect(arena.used() < 4 * sizeof(static_ptr<Step, sizeof(Tracked)>),
+           "products packed by their own size");
+
+    /* Objects never move. */
+    arena.emplace<Tracked>('e');
+    expect(c->name() == 'c', "references stay valid");
+
+    /* Fill up what's left. */
+    size_t extra = 0;
+    while (arena.emplace<Tracked>('x')) {
+      extra++;
+    }
+    expect(arena.used() <= arena.capacity && arena.emplace<Flag>('f'),
+           "a smaller product still fits at the end");
+
+    /* The youngest first; flags have no destructor to run. */
+    arena.reset();
+    expect(destroyed == std::string(extra, 'x') + "eca" && arena.empty() &&
+             arena.used() == 0,
+           "reset destroys in the reverse order");
+
+    /* The whole buffer is available again. */
+    destroyed.clear();
+    arena.emplace<Tracked>('g');
+    expect(arena.size() == 1, "reusable after reset");
+
+    /* Result: destroyed: xeca */
+    std::cout << "destroyed: " << std::string(extra, 'x') << "eca"
+              << std::endl;
+  }
+
+  expect(destroyed == "g", "the destructor resets the arena");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
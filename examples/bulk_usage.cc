@@ -0,0 +1,184 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* The typed bulk APIs advancing a simulation: particles are updated a whole
+ * run at a time, without virtual dispatch, while the rare other bodies go
+ * through their virtual method. The same step runs over
+ * a static_poly_vector and over an array of static_ptr. The program checks
+ * what each callback gets, and fails if anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/bulk_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "static_poly_vector.hpp"
+#include "static_ptr_algorithm.hpp"
+
+struct Body {
+  /* NOTE: the destructor is NOT virtual. */
+  virtual void step(long dt) = 0;
+  virtual long position() const = 0;
+};
+
+/* The hot type. */
+struct Particle final : public Body {
+  long x, v;
+  Particle(long x, long v) : x(x), v(v) {}
+  void step(long dt) override { x += v * dt; }
+  long position() const override { return x; }
+};
+
+/* Everything else. */
+struct Planet final : public Body {
+  long x;
+  explicit Planet(long x) : x(x) {}
+  void step(long) override { x++; }
+  long position() const override { return x; }
+};
+
+template <>
+struct is_trivially_relocatable<Particle> : std::true_type {};
+
+template <>
+struct is_trivially_relocatable<Planet> : std::true_type {};
+
+/* What reached the callbacks. */
+struct step_counts {
+  long runs = 0;
+  long in_runs = 0;
+  long one_by_one = 0;
+};
+
+/* The hot type is handed over as a span, the rest one by one. The loop
+ * over a span is field-wise with a constant stride - open to the
+ * vectorizer. */
+struct stepper {
+  long dt;
+  step_counts& counts;
+
+  template <class Span>
+  void operator()(const Span& particles) const {
+    counts.runs++;
+    counts.in_runs += static_cast<long>(particles.size());
+    for (Particle& p : particles) {
+      p.x += p.v * dt;
+    }
+  }
+
+  void operator()(Body& body) const {
+    counts.one_by_one++;
+    body.step(dt);
+  }
+};
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+static const long count = 64;
+
+static void vector_usage() {
+  static_poly_vector<Body> bodies;
+  for (long i = 0; i < count; i++) {
+    bodies.emplace<Particle>(i, 2);
+    if (i % 16 == 0) {
+      bodies.emplace<Planet>(1000 * i);
+    }
+  }
+
+  /* One span with the whole segment, contiguous. */
+  const static_ptr_span<Particle> span = bodies.span<Particle>();
+  expect(span.size() == count && span.data() == &span[0] &&
+           span[count - 1].x == count - 1,
+         "the segment as a span");
+
+  step_counts counts;
+  bodies.bulk_invoke<Particle>(stepper { 10, counts });
+  expect(counts.runs == 1 && counts.in_runs == count &&
+           counts.one_by_one == 4,
+         "bulk_invoke over the segments");
+
+  long sum = 0;
+  bodies.for_each_typed<Particle>([&](const static_ptr_span<Particle>& ps) {
+    for (const Particle& p : ps) {
+      sum += p.x;
+    }
+  });
+  /* Every particle has moved by 2 * 10. */
+  expect(sum == count * (count - 1) / 2 + count * 20, "particles stepped");
+
+  long planets = 0;
+  bodies.for_each([&](const Body& body) {
+    planets += body.position() % 1000 == 1;
+  });
+  expect(planets == 4, "planets stepped");
+}
+
+static void array_usage() {
+  typedef static_ptr<Body, maxsizeof<Particle, Planet>()> Ptr;
+  Ptr bodies[count];
+
+  /* Runs of 15 particles broken by a planet, and an empty pointer. */
+  for (long i = 0; i < count - 1; i++) {
+    if (i % 16 == 15) {
+      bodies[i].emplace<Planet>(1000 * i);
+    } else {
+      bodies[i].emplace<Particle>(i, 2);
+    }
+  }
+
+  step_counts counts;
+  bulk_invoke<Particle>(bodies, count, stepper { 10, counts });
+  expect(counts.runs == 4 && counts.in_runs == 15 * 4 &&
+           counts.one_by_one == 3,
+         "bulk_invoke over runs");
+
+  /* The runs are spaced by the size of static_ptr. */
+  long runs = 0;
+  long sum = 0;
+  for_each_typed<Particle>(bodies, count, [&](const auto& ps) {
+    static_assert(std::decay<decltype(ps)>::type::stride == sizeof(Ptr),
+                  "strided by static_ptr");
+    runs++;
+    for (const Particle& p : ps) {
+      sum += p.x - 20;
+    }
+  });
+  long expected = 0;
+  for (long i = 0; i < count - 1; i++) {
+    expected += i % 16 == 15 ? 0 : i;
+  }
+  expect(runs == 4 && sum == expected, "for_each_typed over runs");
+
+  expect(bodies[15]->position() == 15001, "planets stepped");
+}
+
+
+int main (void) {
+  vector_usage();
+  array_usage();
+
+  /* Result: bulk steps: ok */
+  std::cout << "bulk steps: " << (ok ? "ok" : "failed") << std::endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
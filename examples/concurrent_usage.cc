@@ -0,0 +1,180 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Products handed over between threads and kept in a shared pool without
+ * a single allocation past the pool's slab. The
+ * program checks what it shows and fails if anything got lost, duplicated
+ * or reordered, so it doubles as a stress test (e.g. under
+ * -fsanitize=thread):
+ *
+ *     g++ -O2 -std=c++17 -pthread -I. examples/concurrent_usage.cc
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "static_pool.hpp"
+#include "static_ring.hpp"
+
+/* Counts the products alive so leaks show up. */
+static std::atomic<long> alive { 0 };
+
+struct Message {
+  Message() { alive++; }
+  Message(const Message&) noexcept { alive++; }
+  Message& operator=(const Message&) noexcept = default;
+  virtual ~Message() { alive--; }
+  virtual unsigned producer() const = 0;
+  virtual unsigned long seq() const = 0;
+};
+
+/* Two concrete types, so the ring carries a real mix. */
+struct Small : public Message {
+  unsigned from;
+  unsigned long n;
+  Small(unsigned from, unsigned long n) : from(from), n(n) {}
+  unsigned producer() const override { return from; }
+  unsigned long seq() const override { return n; }
+};
+
+struct Large : public Message {
+  unsigned from;
+  unsigned long n;
+  char payload[48];
+  Large(unsigned from, unsigned long n) : from(from), n(n), payload{} {}
+  unsigned producer() const override { return from; }
+  unsigned long seq() const override { return n; }
+};
+
+static constexpr unsigned producers = 4;
+static constexpr unsigned long per_producer = 20000;
+
+typedef static_ring<Message, sizeof(Large), 64, static_ring_multi_producer>
+  Ring;
+
+/* Many producers, one consumer. The ring doesn't order messages of
+ * different producers, but messages of each of them must come in the order
+ * they were sent. */
+static bool ring_usage() {
+  static Ring ring;
+
+  std::vector<std::thread> threads;
+  for (unsigned p = 0; p < producers; p++) {
+    threads.emplace_back([p] {
+      for (unsigned long n = 0; n < per_producer; n++) {
+        /* A full ring just makes the producer retry. */
+        while (!(n % 3 ? ring.try_emplace<Small>(p, n)
+                       : ring.try_emplace<Large>(p, n))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  bool ok = true;
+  unsigned long next[producers] = {};
+  unsigned long received = 0;
+  Ring::slot_type msg;
+  while (received < producers * per_producer) {
+    if (!ring.try_pop(msg)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (msg->seq() != next[msg->producer()]++) {
+      ok = false;
+    }
+    msg.reset();
+    received++;
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  /* Result: ring: 80000 messages received in order */
+  std::cout << "ring: " << received << " messages received "
+            << (ok ? "in order" : "OUT OF ORDER") << std::endl;
+  return ok && !ring.try_pop(msg);
+}
+
+
+typedef static_pool<Message, sizeof(Large), 8> Pool;
+
+static constexpr size_t held_per_thread = 32;
+
+/* Every thread keeps a window of products alive and destroys the oldest
+ * one as it makes a new one, so slots keep flowing between magazines and
+ * the shared list. The pool is just big enough for all windows at once:
+ * emplace must never fail, and no product may be overwritten by another
+ * thread's one. */
+static bool pool_usage() {
+  static Pool pool(producers * held_per_thread);
+
+  std::atomic<bool> ok { true };
+  std::vector<std::thread> threads;
+  for (unsigned p = 0; p < producers; p++) {
+    threads.emplace_back([p, &ok] {
+      Pool::handle window[held_per_thread];
+      for (unsigned long n = 0; n < per_producer; n++) {
+        Pool::handle& h = window[n % held_per_thread];
+        if (h && (h->producer() != p ||
+                  h->seq() != n - held_per_thread)) {
+          ok = false;
+        }
+        h.reset();
+        h = n % 3 ? pool.emplace<Small>(p, n) : pool.emplace<Large>(p, n);
+        if (!h) {
+          ok = false;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  /* All the slots are free again, though some sit in the magazines of
+   * threads which have exited. This thread gets them all the same. */
+  std::vector<Pool::handle> all;
+  for (size_t i = 0; i < pool.capacity(); i++) {
+    all.push_back(pool.emplace<Small>(0, i));
+    if (!all.back()) {
+      ok = false;
+    }
+  }
+  if (pool.emplace<Small>(0, 0)) {
+    ok = false;
+  }
+
+  /* Result: pool: 128 slots, all reusable */
+  std::cout << "pool: " << all.size() << " slots, "
+            << (ok ? "all reusable" : "BROKEN") << std::endl;
+  return ok;
+}
+
+
+int main (void) {
+  bool ok = ring_usage();
+  ok = pool_usage() && ok;
+  if (alive != 0) {
+    std::cout << "leaked " << alive << " products" << std::endl;
+    ok = false;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
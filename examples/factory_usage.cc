@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "static_factory.hpp"
+
+struct Interface {
+  /* NOTE: the destructor is NOT virtual. */
+  virtual const char* get_name() const = 0;
+};
+
+struct ConcreteA : public Interface {
+  long member[4];
+  const char* get_name() const override { return "ConcreteA"; }
+};
+
+struct ConcreteB : public Interface {
+  long member[4];
+  ConcreteB(long x)
+    : member { x, 1, 2, 3 } {
+    std::cout << get_name() << " constructed with x=" << x << std::endl;
+  }
+  const char* get_name() const override { return "ConcreteB"; }
+  ~ConcreteB() { std::cout << get_name() << " destructed" << std::endl; }
+};
+
+/* No need to keep a maxsizeof<> list in sync with the products. */
+typedef static_factory<Interface, ConcreteA, ConcreteB> Factory;
+
+
+int main (void) {
+  auto ptrA = Factory::make(Factory::tag_of<ConcreteA>());
+  auto ptrB = Factory::make(Factory::tag_of<ConcreteB>(), 3);
+
+  /* Result: ptrA->get_name(): ConcreteA */
+  std::cout << "ptrA->get_name(): " << ptrA->get_name() << std::endl;
+
+  /* Result:
+   *  ptrB->get_name(): ConcreteB
+   *  ConcreteB destructed */
+  std::cout << "ptrB->get_name(): " << ptrB->get_name() << std::endl;
+
+  return 0;
+}
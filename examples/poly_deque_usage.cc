@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_poly_deque as a round-robin run queue of jobs. The program checks
+ * the order at both ends, rotation of a partly filled and of a full ring,
+ * taking products out and the order of destruction, and fails if anything
+ * is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/poly_deque_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "static_poly_deque.hpp"
+
+static long alive = 0;
+static long moves = 0;
+static std::string destroyed;
+
+struct Job {
+  char id;
+  explicit Job(char id) : id(id) { alive++; }
+  Job(Job&& rhs) : id(rhs.id) { alive++; moves++; }
+  virtual ~Job() { alive--; }
+};
+
+struct Print : public Job {
+  explicit Print(char id) : Job(id) {}
+  Print(Print&&) = default;
+  ~Print() { destroyed += id; }
+};
+
+struct Compute : public Job {
+  long state[4];
+  explicit Compute(char id) : Job(id), state{} {}
+  Compute(Compute&&) = default;
+  ~Compute() { destroyed += id; }
+};
+
+typedef static_poly_deque<Job, maxsizeof<Print, Compute>(), 4> Queue;
+
+static std::string order(const Queue& queue) {
+  std::string result;
+  queue.for_each([&](const Job& job) { result += job.id; });
+  return result;
+}
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+
+int main (void) {
+  {
+    Queue queue;
+    queue.emplace_back<Print>('b');
+    queue.emplace_back<Compute>('c');
+    queue.emplace_front<Compute>('a');
+    expect(order(queue) == "abc" && queue.front().id == 'a' &&
+             queue.back().id == 'c' && queue[1].id == 'b',
+           "both ends");
+
+    /* Not full: the front product is moved to the free slot at the back. */
+    queue.rotate();
+    expect(order(queue) == "bca" && moves == 1, "rotate a partial ring");
+
+    /* Full: the ring just advances, nothing moves. */
+    queue.emplace_back<Print>('d');
+    expect(queue.full() && !queue.emplace_back<Print>('x') &&
+             !queue.emplace_front<Print>('x'),
+           "a full queue rejects products");
+    for (int i = 0; i < 3; i++) {
+      queue.rotate();
+    }
+    expect(order(queue) == "dbca" && moves == 1, "rotate a full ring");
+
+    /* Taking moves the product out of the ring. */
+    Queue::slot_type taken = queue.take_front();
+    expect(taken->id == 'd' && order(queue) == "bca" && alive == 4,
+           "take_front");
+
+    /* Moves destroyed the moved-from products, start counting afresh. */
+    destroyed.clear();
+    expect(queue.pop_back() && order(queue) == "bc" && destroyed == "a",
+           "pop_back");
+    taken.reset();
+
+    /* Wrapping around the end of the slots keeps the order. */
+    queue.emplace_front<Print>('e');
+    queue.emplace_front<Print>('f');
+    expect(order(queue) == "febc", "wrapped around");
+
+    /* The back one first. */
+    destroyed.clear();
+    queue.clear();
+    expect(destroyed == "cbef" && queue.empty() && !queue.pop_front(),
+           "clear destroys from the back");
+
+    /* Result: moves 2 */
+    std::cout << "moves " << moves << std::endl;
+  }
+
+  expect(alive == 0, "no job leaked");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_poly_vector keeping shapes in one segment per concrete type. The
+ * program checks the segments, both kinds of iteration and the growth of
+ * relocatable and non-relocatable segments, and fails if anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/poly_vector_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "static_poly_vector.hpp"
+
+static long alive = 0;
+static long moves = 0;
+static long label_moves = 0;
+
+struct Shape {
+  Shape() { alive++; }
+  Shape(Shape&&) { alive++; moves++; }
+  virtual ~Shape() { alive--; }
+  virtual long area() const = 0;
+};
+
+struct Square : public Shape {
+  long side;
+  explicit Square(long side) : side(side) {}
+  long area() const override { return side * side; }
+};
+
+/* Squares own no resources, so growing their segment is a memcpy. */
+template <>
+struct is_trivially_relocatable<Square> : std::true_type {};
+
+/* The string makes Labels non-relocatable: they are moved one by one. */
+struct Label : public Shape {
+  std::string text;
+  explicit Label(const char* text) : text(text) {}
+  Label(Label&& rhs) : Shape(std::move(rhs)), text(std::move(rhs.text)) {
+    label_moves++;
+  }
+  long area() const override { return static_cast<long>(text.size()); }
+};
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+
+int main (void) {
+  {
+    static_poly_vector<Shape> shapes;
+    long squares = 0;
+    for (long i = 1; i <= 100; i++) {
+      shapes.emplace<Square>(i);
+      squares += i * i;
+      if (i % 10 == 0) {
+        shapes.emplace<Label>("a label long enough to be heap-allocated");
+      }
+    }
+    expect(shapes.size() == 110 && shapes.segment_count() == 2,
+           "one segment per type");
+
+    /* The segment of squares grew several times without moving any of
+     * them, the labels have been moved through their LCM. */
+    expect(label_moves > 0 && moves == label_moves,
+           "only labels moved on growth");
+    const long grown_moves = label_moves;
+
+    /* Virtual dispatch, one segment at a time. */
+    long total = 0;
+    shapes.for_each([&](const Shape& s) { total += s.area(); });
+    expect(total == squares + 10 * 40, "for_each visits every element");
+
+    /* No dispatch at all. Order within a segment is that of emplacement. */
+    long next = 1;
+    bool ordered = true;
+    shapes.for_each<Square>([&](Square& sq) {
+      ordered = ordered && sq.side == next++;
+    });
+    expect(ordered && next == 101, "for_each<Square> in order");
+
+    long labels = 0;
+    shapes.for_each<Label>([&](Label& l) {
+      labels += l.text == "a label long enough to be heap-allocated";
+    });
+    expect(labels == 10, "labels survived the growth");
+
+    /* clear keeps the memory: emplacing again doesn't grow. */
+    shapes.clear();
+    expect(shapes.empty() && alive == 0, "clear destroys everything");
+    for (int i = 0; i < 10; i++) {
+      shapes.emplace<Label>("again");
+    }
+    expect(label_moves == grown_moves, "no growth after clear");
+
+    /* Result: total area 338750, label moves 8 */
+    std::cout << "total area " << total << ", label moves " << grown_moves
+              << std::endl;
+  }
+
+  expect(alive == 0, "no element leaked");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
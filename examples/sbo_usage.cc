@@ -0,0 +1,139 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_sbo_ptr keeping small products inline and spilling big ones to
+ * a std::pmr memory resource. The program checks where every product ends
+ * up and what gets allocated, and fails if anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/sbo_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+
+#include "static_sbo_ptr.hpp"
+
+/* Counts what goes through it, so the spills can be seen. */
+struct counting_resource : public std::pmr::memory_resource {
+  const char* const name;
+  long allocations = 0;
+  long outstanding = 0;
+
+  explicit counting_resource(const char* name) : name(name) {}
+
+  void* do_allocate(size_t bytes, size_t align) override {
+    allocations++;
+    outstanding++;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    outstanding--;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& rhs) const
+      noexcept override {
+    return this == &rhs;
+  }
+};
+
+static long alive = 0;
+
+struct Shape {
+  Shape() { alive++; }
+  Shape(Shape&&) { alive++; }
+  virtual ~Shape() { alive--; }
+  virtual long area() const = 0;
+};
+
+struct Square : public Shape {
+  long side;
+  explicit Square(long side) : side(side) {}
+  long area() const override { return side * side; }
+};
+
+/* Way bigger than the inline storage. */
+struct Polygon : public Shape {
+  long points[32];
+  explicit Polygon(long n) : points{} { points[0] = n; }
+  long area() const override { return points[0]; }
+};
+
+typedef std::pmr::polymorphic_allocator<std::max_align_t> Alloc;
+typedef static_sbo_ptr<Shape, sizeof(Square), Alloc> Ptr;
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+
+int main (void) {
+  counting_resource first("first"), second("second");
+  {
+    /* Small products never touch the resource. */
+    Ptr square { Alloc(&first) };
+    square.emplace<Square>(3);
+    expect(!square.is_spilled() && first.allocations == 0, "inline square");
+
+    /* Big ones spill. */
+    Ptr polygon { Alloc(&first) };
+    polygon.emplace<Polygon>(42);
+    expect(polygon.is_spilled() && first.allocations == 1, "spilled polygon");
+
+    /* Moving a spilled product steals its memory together with the
+     * allocator: no allocation, no move of the product. */
+    const Shape* const where = polygon.get();
+    Ptr stolen(std::move(polygon));
+    expect(stolen.get() == where && !polygon.get() &&
+             first.allocations == 1,
+           "move-construction steals the spilled product");
+
+    /* polymorphic_allocator doesn't propagate on move-assignment. With
+     * a different resource on the left the product must be moved into
+     * memory of that resource, and the old one given back. */
+    Ptr other { Alloc(&second) };
+    other = std::move(stolen);
+    expect(other.is_spilled() && other.get() != where &&
+             other->area() == 42 && !stolen.get(),
+           "move-assignment across resources");
+    expect(second.allocations == 1 && first.outstanding == 0,
+           "memory moved to the second resource");
+
+    /* Inline products are moved across resources as they would be within
+     * one. */
+    other = std::move(square);
+    expect(!other.is_spilled() && other->area() == 9 &&
+             second.outstanding == 0,
+           "inline product replaces the spilled one");
+
+    /* Result: square area 9, spills: first=1 second=1 */
+    std::cout << "square area " << other->area()
+              << ", spills: first=" << first.allocations
+              << " second=" << second.allocations << std::endl;
+  }
+
+  expect(alive == 0, "no product leaked");
+  expect(first.outstanding == 0 && second.outstanding == 0,
+         "no memory leaked");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
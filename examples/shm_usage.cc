@@ -0,0 +1,149 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_shm_ptr handing a message from one process to another through
+ * shared memory. The parent emplaces it, the forked child registers the
+ * products on its own, consumes the message in place and destroys it. The
+ * program checks both sides and fails if anything is off:
+ *
+ *     g++ -O2 -std=c++17 -I. examples/shm_usage.cc
+ */
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include "static_shm_ptr.hpp"
+
+struct Message {
+  /* NOTE: the destructor is NOT virtual. */
+  virtual long value() const = 0;
+};
+
+/* No pointers inside, so the products mean the same in every process. */
+struct Price final : public Message {
+  long cents;
+  explicit Price(long cents) : cents(cents) {}
+  long value() const override { return cents; }
+};
+
+struct Order final : public Message {
+  long quantity;
+  long cents;
+  Order(long quantity, long cents) : quantity(quantity), cents(cents) {}
+  long value() const override { return quantity * cents; }
+};
+
+/* Collides with Price on purpose. */
+struct Impostor : public Message {
+  long value() const override { return -1; }
+};
+
+template <> struct static_shm_type_index<Price>
+  : std::integral_constant<uint32_t, 1> {};
+template <> struct static_shm_type_index<Order>
+  : std::integral_constant<uint32_t, 2> {};
+template <> struct static_shm_type_index<Impostor>
+  : std::integral_constant<uint32_t, 1> {};
+
+typedef static_shm_ptr<Message, maxsizeof<Price, Order>()> Ptr;
+
+/* What both processes see. */
+struct shared_area {
+  Ptr message;
+  std::atomic<bool> ready { false };
+};
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+static int consume(shared_area& area) {
+  while (!area.ready.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  /* The child emplaces nothing, so it registers what it's going to
+   * destroy by hand. */
+  expect(static_shm_registry::find(2) == nullptr, "not registered yet");
+  static_shm_registry::add<Order>();
+
+  /* visit dispatches by the stable index; the products are final, so no
+   * vptr is involved. */
+  const long total = area.message.visit<Price, Order>(
+    [](auto& msg) { return msg.value(); });
+  expect(area.message.get_as<Order>() && total == 3 * 250,
+         "the child sees the order");
+
+  area.message.reset();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+int main (void) {
+  void* const mem = mmap(nullptr, sizeof(shared_area), PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    return EXIT_FAILURE;
+  }
+  shared_area* const area = new (mem) shared_area;
+
+  const pid_t child = fork();
+  if (child < 0) {
+    return EXIT_FAILURE;
+  }
+  if (child == 0) {
+    _exit(consume(*area));
+  }
+
+  /* Stable indices are per product: one taken by Price can't be reused. */
+  Ptr local;
+  expect(local.try_emplace<Price>(99) == static_ptr_status::ok,
+         "price emplaced");
+  local.reset();
+  expect(local.try_emplace<Impostor>() == static_ptr_status::index_taken &&
+           local.emplace<Impostor>() && !local.get(),
+         "impostor rejected");
+
+  area->message.emplace<Order>(3, 250);
+  expect(area->message.type_index() == 2, "order emplaced");
+  area->ready.store(true, std::memory_order_release);
+
+  int status = 0;
+  waitpid(child, &status, 0);
+  expect(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS,
+         "the child succeeded");
+  expect(!area->message.get(), "the child has destroyed the order");
+
+  /* Result: message consumed: yes */
+  std::cout << "message consumed: " << (area->message.get() ? "no" : "yes")
+            << std::endl;
+
+  area->~shared_area();
+  munmap(mem, sizeof(shared_area));
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
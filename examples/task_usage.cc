@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* static_task running coroutines in caller-owned frames. The program checks
+ * which frames end up in a static_task_frame and which fall back to the
+ * allocator, and fails if anything is off. Unlike the other examples it
+ * needs C++20:
+ *
+ *     g++ -O2 -std=c++20 -I. examples/task_usage.cc
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <stdexcept>
+
+#include "static_task.hpp"
+
+/* Counts the fallback frames. */
+struct counting_resource : public std::pmr::memory_resource {
+  long allocations = 0;
+  long outstanding = 0;
+
+  void* do_allocate(size_t bytes, size_t align) override {
+    allocations++;
+    outstanding++;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    outstanding--;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& rhs) const
+      noexcept override {
+    return this == &rhs;
+  }
+};
+
+typedef std::pmr::polymorphic_allocator<std::max_align_t> Alloc;
+typedef static_task<long, 512, Alloc> Task;
+typedef static_task_frame<512> Frame;
+
+static Task square(Frame&, std::allocator_arg_t, Alloc, long x) {
+  co_return x * x;
+}
+
+/* Awaits another task living in its own frame. */
+static Task sum_of_squares(Frame&, std::allocator_arg_t, Alloc alloc,
+                           Frame& inner, long x, long y) {
+  const long xx = co_await square(inner, std::allocator_arg, alloc, x);
+  const long yy = co_await square(inner, std::allocator_arg, alloc, y);
+  co_return xx + yy;
+}
+
+static Task fail(Frame&, std::allocator_arg_t, Alloc) {
+  throw std::runtime_error("failed");
+  co_return 0;
+}
+
+static bool ok = true;
+
+static void expect(bool cond, const char* what) {
+  if (!cond) {
+    std::cout << "FAILED: " << what << std::endl;
+    ok = false;
+  }
+}
+
+
+int main (void) {
+  counting_resource resource;
+  const Alloc alloc(&resource);
+  Frame outer, inner;
+  long result = 0;
+
+  {
+    /* Both frames are used, one after another for the inner tasks. */
+    Task task = sum_of_squares(outer, std::allocator_arg, alloc, inner, 3, 4);
+    expect(outer.busy && !inner.busy, "the outer task is in its frame");
+    task.resume();
+    expect(task.done() && !inner.busy, "the inner tasks are gone");
+    result = task.result();
+    expect(result == 25 && Task::fallbacks() == 0 &&
+             resource.allocations == 0,
+           "no fallback for fitting frames");
+  }
+  expect(!outer.busy, "the frame is free again");
+
+  {
+    /* The frame holds one coroutine at a time: the second one goes to the
+     * allocator. */
+    Task first = square(outer, std::allocator_arg, alloc, 5);
+    Task second = square(outer, std::allocator_arg, alloc, 6);
+    expect(Task::fallbacks() == 1 && resource.outstanding == 1,
+           "a busy frame falls back");
+    first.resume();
+    second.resume();
+    expect(first.result() == 25 && second.result() == 36,
+           "both tasks completed");
+  }
+  expect(resource.outstanding == 0, "the fallback frame is given back");
+
+  {
+    /* What the coroutine lets out is rethrown by result(). */
+    Task task = fail(outer, std::allocator_arg, alloc);
+    task.resume();
+    bool thrown = false;
+    try {
+      task.result();
+    } catch (const std::runtime_error&) {
+      thrown = true;
+    }
+    expect(thrown, "the exception reaches the caller");
+  }
+
+  /* Result: 3^2 + 4^2 = 25, fallbacks 1 */
+  std::cout << "3^2 + 4^2 = " << result << ", fallbacks "
+            << Task::fallbacks() << std::endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,247 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_ANY_HPP
+#define STATIC_ANY_HPP
+
+#include <any>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* static_any is std::any with fixed, inline capacity: it holds a value of
+ * any type - without the common base static_ptr needs - as long as it fits
+ * MaxSize and Align. That's checked at compile-time, so there is no hidden
+ * allocation for bigger values like with std::any; they just don't
+ * compile.
+ *
+ * The value is managed through the same LCM as static_ptr's objects (moves
+ * of trivially relocatable types are a memcpy), and its type is recognized
+ * by the LCM's type id, so any_cast needs no RTTI. Unlike std::any,
+ * static_any is move-only - like static_ptr. And like static_ptr's, its
+ * moves are noexcept only when NothrowMove is set; values with a throwing
+ * move constructor are rejected then. */
+template <size_t MaxSize,
+          size_t Align = alignof(typename std::aligned_storage<MaxSize>::type),
+          bool NothrowMove = false>
+class static_any;
+
+/* Types the from-value constructor of static_any must keep away from. */
+template <class T>
+struct static_any_is_special : std::false_type {};
+
+template <size_t MaxSize, size_t Align, bool NothrowMove>
+struct static_any_is_special<static_any<MaxSize, Align, NothrowMove>>
+  : std::true_type {};
+
+template <class T>
+struct static_any_is_special<std::in_place_type_t<T>> : std::true_type {};
+
+template <size_t MaxSize, size_t Align, bool NothrowMove>
+class static_any {
+  template <size_t Sf, size_t Af, bool Nf> friend class static_any;
+
+public:
+  static constexpr size_t element_max_size = MaxSize;
+  static constexpr size_t element_max_align = Align;
+  static constexpr bool nothrow_move = NothrowMove;
+
+private:
+  typedef typename std::aligned_storage<element_max_size,
+                                        element_max_align>::type storage_t;
+
+  mutable storage_t storage_obj;
+  const static_lcm* lcm = nullptr;
+
+  template <class Te, class... Args>
+  void _emplace(Args&&... args) {
+    static_assert(element_max_size >= sizeof(Te),
+                  "emplaced too big class");
+    static_assert(element_max_align >= alignof(Te),
+                  "emplaced class is over-aligned for the storage");
+    static_assert(!nothrow_move ||
+                    std::is_nothrow_move_constructible<Te>::value,
+                  "emplaced class with throwing move constructor");
+
+    new (&storage_obj) Te(std::forward<Args>(args)...);
+    lcm = &static_lcm_for<Te>::value;
+  }
+
+  void _release() noexcept {
+    const static_lcm* const this_lcm = lcm;
+    if (this_lcm) {
+      lcm = nullptr;
+      this_lcm->delete_obj(&storage_obj);
+    }
+  }
+
+  template <size_t Sf, size_t Af, bool Nf>
+  void _transfer_obj(static_any<Sf, Af, Nf>&& rhs) noexcept(nothrow_move) {
+    static_ptr_transfer_obj(&storage_obj, lcm,
+                            &rhs.storage_obj, rhs.lcm,
+                            sizeof(rhs.storage_obj));
+  }
+
+public:
+  static_any() noexcept = default;
+
+  static_any(static_any&& rhs) noexcept(nothrow_move) {
+    _transfer_obj(std::move(rhs));
+  }
+
+  /* Constructor: move from a smaller variant of static_any. */
+  template <size_t Sf, size_t Af, bool Nf>
+  static_any(static_any<Sf, Af, Nf>&& rhs) noexcept(nothrow_move) {
+    static_assert(element_max_size >= Sf,
+                  "constructed from too big static_any instance");
+    static_assert(element_max_align >= Af,
+                  "constructed from too aligned static_any instance");
+    static_assert(!nothrow_move || Nf,
+                  "constructed from static_any with throwing moves");
+    _transfer_obj(std::move(rhs));
+  }
+
+  /* Constructor: from a value, which is copied or moved in. */
+  template <
+    class T,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      !static_any_is_special<typename std::decay<T>::type>::value>::type*
+        = nullptr >
+  static_any(T&& value) {
+    _emplace<typename std::decay<T>::type>(std::forward<T>(value));
+  }
+
+  /* Constructor: construct Te in place. */
+  template <class Te, class... Args>
+  explicit static_any(std::in_place_type_t<Te>, Args&&... args) {
+    _emplace<Te>(std::forward<Args>(args)...);
+  }
+
+  template <size_t Sf, size_t Af, bool Nf>
+  static_any& operator=(static_any<Sf, Af, Nf>&& rhs) noexcept(nothrow_move) {
+    static_assert(element_max_size >= Sf,
+                  "assigned from too big static_any instance");
+    static_assert(element_max_align >= Af,
+                  "assigned from too aligned static_any instance");
+    static_assert(!nothrow_move || Nf,
+                  "assigned from static_any with throwing moves");
+
+    if (static_cast<const void*>(&rhs) != this) {
+      _release();
+      _transfer_obj(std::move(rhs));
+    }
+    return *this;
+  }
+
+  static_any& operator=(static_any&& rhs) noexcept(nothrow_move) {
+    return operator=<MaxSize, Align, NothrowMove>(std::move(rhs));
+  }
+
+  static_any(const static_any&) = delete;
+  static_any& operator=(const static_any&) = delete;
+
+  ~static_any() {
+    _release();
+  }
+
+  /* Replace the held value (if any) with a new Te. */
+  template <class Te, class... Args>
+  Te& emplace(Args&&... args) {
+    _release();
+    _emplace<Te>(std::forward<Args>(args)...);
+    return *reinterpret_cast<Te*>(&storage_obj);
+  }
+
+  void reset() noexcept {
+    _release();
+  }
+
+  bool has_value() const noexcept {
+    return lcm != nullptr;
+  }
+
+  /* The static_type_id of the held value; nullptr if there is none. */
+  const void* type_id() const noexcept {
+    return lcm ? lcm->type_id : nullptr;
+  }
+
+  template <class T>
+  bool holds() const noexcept {
+    return type_id() == static_type_id<T>::value;
+  }
+
+  /* Unchecked access; see any_cast for the checked one. */
+  template <class T>
+  T* get() const noexcept {
+    return reinterpret_cast<T*>(&storage_obj);
+  }
+};
+
+
+/* The counterparts of std::any_cast. The pointer ones return nullptr on
+ * a type mismatch, the reference ones throw std::bad_any_cast. The type
+ * must match exactly up to cv-qualifiers - any_cast to a base class fails,
+ * as with std::any. */
+template <class T, size_t MaxSize, size_t Align, bool Nf>
+T* any_cast(static_any<MaxSize, Align, Nf>* any) noexcept {
+  typedef typename std::remove_cv<T>::type value_t;
+  return any && any->template holds<value_t>() ? any->template get<T>()
+                                               : nullptr;
+}
+
+template <class T, size_t MaxSize, size_t Align, bool Nf>
+const T* any_cast(const static_any<MaxSize, Align, Nf>* any) noexcept {
+  typedef typename std::remove_cv<T>::type value_t;
+  return any && any->template holds<value_t>() ? any->template get<T>()
+                                               : nullptr;
+}
+
+template <class T, size_t MaxSize, size_t Align, bool Nf>
+T any_cast(static_any<MaxSize, Align, Nf>& any) {
+  typedef typename std::remove_cv<
+    typename std::remove_reference<T>::type>::type value_t;
+  if (!any.template holds<value_t>()) {
+    static_ptr_throw(std::bad_any_cast());
+  }
+  return static_cast<T>(*any.template get<value_t>());
+}
+
+template <class T, size_t MaxSize, size_t Align, bool Nf>
+T any_cast(const static_any<MaxSize, Align, Nf>& any) {
+  typedef typename std::remove_cv<
+    typename std::remove_reference<T>::type>::type value_t;
+  if (!any.template holds<value_t>()) {
+    static_ptr_throw(std::bad_any_cast());
+  }
+  return static_cast<T>(*any.template get<const value_t>());
+}
+
+template <class T, size_t MaxSize, size_t Align, bool Nf>
+T any_cast(static_any<MaxSize, Align, Nf>&& any) {
+  typedef typename std::remove_cv<
+    typename std::remove_reference<T>::type>::type value_t;
+  if (!any.template holds<value_t>()) {
+    static_ptr_throw(std::bad_any_cast());
+  }
+  return static_cast<T>(std::move(*any.template get<value_t>()));
+}
+
+#endif /* STATIC_ANY_HPP */
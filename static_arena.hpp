@@ -0,0 +1,183 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_ARENA_HPP
+#define STATIC_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* static_arena is an inline buffer of Bytes holding many products of
+ * different sizes at once - e.g. all the polymorphic state of a request
+ * living in one stack block. Where static_ptr reserves MaxSize for every
+ * object, here each takes just its size, a small header pointing to its
+ * LCM and the padding its alignment needs.
+ *
+ * Objects are bump-allocated and never freed one by one; reset (or the
+ * destructor) destroys all of them in the reverse order of creation. When
+ * every product is trivially destructible, reset costs O(1). Objects don't
+ * move, so references handed out by emplace stay valid until reset. */
+template <class Interface,
+          size_t Bytes,
+          size_t Align = alignof(std::max_align_t)>
+class static_arena {
+  static_assert(Bytes < UINT16_MAX,
+                "static_arena uses 16-bit offsets");
+
+public:
+  typedef Interface element_type;
+  static constexpr size_t capacity = Bytes;
+
+private:
+  struct header {
+    const static_lcm* lcm;
+    /* Offset of the previous header plus one; zero for the first one. */
+    uint16_t prev;
+    /* Offsets from the header to the object and from the object to its
+     * Interface subobject. */
+    uint16_t to_obj;
+    uint16_t to_base;
+  };
+
+  alignas(Align) unsigned char buffer[Bytes];
+  size_t top = 0;
+  size_t last = 0;
+  size_t count = 0;
+  bool trivial = true;
+
+  header* _header(size_t offset) const noexcept {
+    return reinterpret_cast<header*>(
+      const_cast<unsigned char*>(buffer) + offset);
+  }
+
+  unsigned char* _obj(size_t offset) const noexcept {
+    return reinterpret_cast<unsigned char*>(_header(offset)) +
+           _header(offset)->to_obj;
+  }
+
+  /* Offset of the header following the one at offset. */
+  size_t _next(size_t offset) const noexcept {
+    const header* const hdr = _header(offset);
+    return static_ptr_round_up(offset + hdr->to_obj + hdr->lcm->obj_size,
+                               alignof(header));
+  }
+
+public:
+  static_arena() noexcept = default;
+
+  static_arena(const static_arena&) = delete;
+  static_arena& operator=(const static_arena&) = delete;
+
+  ~static_arena() {
+    reset();
+  }
+
+  /* Construct a new Te at the top of the arena. Returns nullptr when there
+   * isn't enough room left. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  Te* emplace(Args&&... args) {
+    static_assert(alignof(Te) <= Align,
+                  "emplaced class is over-aligned for the arena");
+
+    const size_t hdr_offset = static_ptr_round_up(top, alignof(header));
+    const size_t obj_offset =
+      static_ptr_round_up(hdr_offset + sizeof(header), alignof(Te));
+    if (obj_offset + sizeof(Te) > Bytes) {
+      return nullptr;
+    }
+
+    Te* const obj = new (buffer + obj_offset) Te(std::forward<Args>(args)...);
+
+    header* const hdr = new (buffer + hdr_offset) header;
+    hdr->lcm = &static_lcm_for<Te>::value;
+    hdr->prev = static_cast<uint16_t>(count ? last + 1 : 0);
+    hdr->to_obj = static_cast<uint16_t>(obj_offset - hdr_offset);
+    hdr->to_base = static_cast<uint16_t>(
+      reinterpret_cast<unsigned char*>(static_cast<Interface*>(obj)) -
+      reinterpret_cast<unsigned char*>(obj));
+
+    trivial = trivial && std::is_trivially_destructible<Te>::value;
+    last = hdr_offset;
+    top = obj_offset + sizeof(Te);
+    count++;
+    return obj;
+  }
+
+  /* Destroy all objects, the youngest first, and make the whole buffer
+   * available again. */
+  void reset() noexcept {
+    if (!trivial && count) {
+      size_t offset = last;
+      while (true) {
+        const header* const hdr = _header(offset);
+        hdr->lcm->delete_obj(_obj(offset));
+        if (!hdr->prev) {
+          break;
+        }
+        offset = hdr->prev - 1;
+      }
+    }
+    top = 0;
+    last = 0;
+    count = 0;
+    trivial = true;
+  }
+
+  size_t size() const noexcept {
+    return count;
+  }
+
+  bool empty() const noexcept {
+    return count == 0;
+  }
+
+  /* Bytes taken, headers and padding included. */
+  size_t used() const noexcept {
+    return top;
+  }
+
+  /* Call f with Interface& of every object in the order of creation. */
+  template <class F>
+  void for_each(F&& f) const {
+    for (size_t offset = 0, i = 0; i < count; offset = _next(offset), i++) {
+      f(*reinterpret_cast<Interface*>(_obj(offset) +
+                                      _header(offset)->to_base));
+    }
+  }
+
+  /* The same in the reverse order. */
+  template <class F>
+  void for_each_reverse(F&& f) const {
+    for (size_t offset = last, i = 0; i < count;
+         offset = _header(offset)->prev - 1, i++) {
+      f(*reinterpret_cast<Interface*>(_obj(offset) +
+                                      _header(offset)->to_base));
+    }
+  }
+};
+
+#endif /* STATIC_ARENA_HPP */
@@ -0,0 +1,125 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_FACTORY_HPP
+#define STATIC_FACTORY_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* Position of Te on the list of types. Asking for a type that isn't there
+ * ends with a compilation error. */
+template <class Te, class... Types>
+struct static_factory_index;
+
+template <class Te, class... Tail>
+struct static_factory_index<Te, Te, Tail...>
+  : std::integral_constant<size_t, 0> {};
+
+template <class Te, class Head, class... Tail>
+struct static_factory_index<Te, Head, Tail...>
+  : std::integral_constant<size_t,
+                           1 + static_factory_index<Te, Tail...>::value> {};
+
+
+/* static_factory generalizes the hand-written factories returning static_ptr:
+ *
+ *     static_ptr<Interface, maxsizeof<ConcreteA, ConcreteB>()>
+ *     make_instance(bool first_one) {
+ *       if (first_one) {
+ *         return make_static<ConcreteA>();
+ *       } else {
+ *         return make_static<ConcreteB>(3);
+ *       }
+ *     }
+ *
+ * The list of products is given once and the storage size as well as its
+ * alignment are deduced from it.
+ * Products are identified by runtime tags (their positions on the list, see
+ * tag_of) and built through a constexpr table of constructor thunks. Thus
+ * picking the product costs one indirect jump regardless of the number of
+ * products, in contrast to a chain of branches.
+ *
+ *     typedef static_factory<Interface, ConcreteA, ConcreteB> Factory;
+ *     Factory::pointer ptr = Factory::make(Factory::tag_of<ConcreteB>(), 3);
+ */
+template <class Interface, class... Products>
+class static_factory {
+public:
+  /* When none of the products needs its destructor, so doesn't the
+   * pointer. */
+  typedef static_ptr<Interface,
+                     maxsizeof<Products...>(),
+                     maxalignof<Products...>(),
+                     alltriviallydestructible<Products...>()> pointer;
+  static constexpr size_t product_count = sizeof...(Products);
+
+  template <class Te>
+  static constexpr size_t tag_of() {
+    return static_factory_index<Te, Products...>::value;
+  }
+
+private:
+  /* The thunk for a product that can be constructed from Args. */
+  template <class Te, class Ptr, class... Args>
+  static void _construct(std::true_type, Ptr& ptr, Args&&... args) {
+    ptr.template emplace<Te>(std::forward<Args>(args)...);
+  }
+
+  /* The thunk for a product that can't be constructed from Args. Picking
+   * it leaves the pointer empty. */
+  template <class Te, class Ptr, class... Args>
+  static void _construct(std::false_type, Ptr&, Args&&...) {
+  }
+
+  template <class Te, class Ptr, class... Args>
+  static void construct(Ptr& ptr, Args&&... args) {
+    _construct<Te, Ptr, Args...>(std::is_constructible<Te, Args&&...>(),
+                                 ptr, std::forward<Args>(args)...);
+  }
+
+public:
+  /* Build the product with the given tag. Arguments are forwarded to its
+   * constructor. The returned pointer is empty if the tag is out of range
+   * or the product isn't constructible from the arguments. */
+  template <class... Args>
+  static pointer make(size_t tag, Args&&... args) {
+    return make_as<pointer>(tag, std::forward<Args>(args)...);
+  }
+
+  /* Like make but builds the product straight in the caller's variant of
+   * static_ptr (e.g. a bigger one shared by several factories). Converting
+   * the result of make would cost a move of the product. */
+  template <class Ptr, class... Args>
+  static Ptr make_as(size_t tag, Args&&... args) {
+    typedef void (*thunk_t)(Ptr&, Args&&...);
+    static constexpr thunk_t thunks[] = {
+      &construct<Products, Ptr, Args...>...
+    };
+
+    Ptr ptr;
+    if (tag < product_count) {
+      thunks[tag](ptr, std::forward<Args>(args)...);
+    }
+    return ptr;
+  }
+};
+
+#endif /* STATIC_FACTORY_HPP */
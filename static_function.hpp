@@ -0,0 +1,233 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_FUNCTION_HPP
+#define STATIC_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+template <class Signature,
+          size_t MaxSize,
+          size_t Align = alignof(typename std::aligned_storage<MaxSize>::type),
+          bool NothrowMove = false>
+class static_function;
+
+/* Types the from-callable constructor of static_function must keep away
+ * from. */
+template <class T>
+struct static_function_is_special : std::false_type {};
+
+template <class Signature, size_t MaxSize, size_t Align, bool NothrowMove>
+struct static_function_is_special<
+  static_function<Signature, MaxSize, Align, NothrowMove>>
+  : std::true_type {};
+
+template <>
+struct static_function_is_special<nullptr_t> : std::true_type {};
+
+/* static_function is a move-only, allocation-free replacement for
+ * std::function. The capacity is fixed at compile-time and a callable that
+ * doesn't fit is a compilation error - exactly like with make_static and
+ * static_ptr. The callable's life cycle is handled by the same LCM static_ptr
+ * uses, while the invoke thunk is kept directly in the object. Calling costs
+ * one indirect call then; there is no extra hop through the LCM.
+ *
+ *     static_function<void(int), 32> on_complete = [this](int r) {
+ *       finish(r);
+ *     };
+ *
+ * As with static_ptr, moves are noexcept only when NothrowMove is set, and
+ * then callables with a throwing move constructor don't compile. */
+template <class R, class... Args, size_t MaxSize, size_t Align,
+          bool NothrowMove>
+class static_function<R(Args...), MaxSize, Align, NothrowMove> {
+  /* All variants of static_function are friends. */
+  template <class Sf, size_t Mf, size_t Af, bool Nf>
+  friend class static_function;
+public:
+  typedef R result_type;
+  static constexpr size_t element_max_size = MaxSize;
+  static constexpr size_t element_max_align = Align;
+  static constexpr bool nothrow_move = NothrowMove;
+
+private:
+  typedef R (*invoke_t)(void*, Args&&...);
+  typedef typename std::aligned_storage<element_max_size,
+                                        element_max_align>::type storage_t;
+
+  mutable storage_t storage_obj;
+  /* As in static_ptr, nullptr LCM means empty. */
+  const static_lcm* lcm = nullptr;
+  invoke_t invoke = &_invoke_empty;
+
+  /* Like std::function, a void signature discards whatever the callable
+   * returns. */
+  template <class F>
+  static R _invoke(void* obj, Args&&... args) {
+    if constexpr (std::is_void<R>::value) {
+      std::invoke(*static_cast<F*>(obj), std::forward<Args>(args)...);
+    } else {
+      return std::invoke(*static_cast<F*>(obj), std::forward<Args>(args)...);
+    }
+  }
+
+  /* Calling an empty static_function behaves like calling an empty
+   * std::function. The thunk spares us checking for emptiness on each
+   * call. */
+  static R _invoke_empty(void*, Args&&...) {
+    static_ptr_throw(std::bad_function_call());
+  }
+
+  template <class F>
+  void _emplace(F&& f) {
+    typedef typename std::decay<F>::type Fd;
+
+    static_assert(element_max_size >= sizeof(Fd),
+                  "constructed from too big callable");
+    static_assert(element_max_align >= alignof(Fd),
+                  "constructed from too aligned callable");
+    static_assert(!nothrow_move ||
+                    std::is_nothrow_move_constructible<Fd>::value,
+                  "constructed from callable with throwing move constructor");
+
+    new (&storage_obj) Fd(std::forward<F>(f));
+    lcm = &static_lcm_for<Fd>::value;
+    invoke = &_invoke<Fd>;
+  }
+
+  void _release() noexcept {
+    if (lcm) {
+      const static_lcm* const this_lcm = lcm;
+      lcm = nullptr;
+      invoke = &_invoke_empty;
+      this_lcm->delete_obj(&storage_obj);
+    }
+  }
+
+  template <size_t Mf, size_t Af, bool Nf>
+  void _transfer_obj(static_function<R(Args...), Mf, Af, Nf>&& rhs)
+      noexcept(nothrow_move) {
+    if (!rhs.lcm) {
+      return;
+    }
+
+    /* The object goes the way of static_ptr's ones. The thunk follows it
+     * only once it's there - a throwing move leaves both sides intact. */
+    const invoke_t rhs_invoke = rhs.invoke;
+    static_ptr_transfer_obj(&storage_obj, lcm,
+                            &rhs.storage_obj, rhs.lcm,
+                            sizeof(rhs.storage_obj));
+    invoke = rhs_invoke;
+    rhs.invoke = &_invoke_empty;
+  }
+
+  /* Whether F is a callable static_function can be constructed from: one
+   * invocable with Args and returning something convertible to R. */
+  template <class F, class Fd = typename std::decay<F>::type>
+  struct is_invocable_as
+    : std::conjunction<std::negation<static_function_is_special<Fd>>,
+                       std::is_invocable_r<R, Fd&, Args...>> {};
+
+public:
+  static_function() noexcept = default;
+
+  static_function(nullptr_t) noexcept : static_function() {}
+
+  /* Constructor: from any callable. It is stored in-place. */
+  template <
+    class F,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<is_invocable_as<F>::value>::type* = nullptr >
+  static_function(F&& f) {
+    _emplace(std::forward<F>(f));
+  }
+
+  /* Constructor: move from static_function with the same signature and
+   * not bigger storage. */
+  template <size_t Mf, size_t Af, bool Nf>
+  static_function(static_function<R(Args...), Mf, Af, Nf>&& rhs)
+      noexcept(nothrow_move) {
+    static_assert(element_max_size >= Mf,
+                  "constructed from too big static_function instance");
+    static_assert(element_max_align >= Af,
+                  "constructed from too aligned static_function instance");
+    static_assert(!nothrow_move || Nf,
+                  "constructed from static_function with throwing moves");
+
+    _transfer_obj(std::move(rhs));
+  }
+
+  static_function(static_function&& rhs) noexcept(nothrow_move) {
+    _transfer_obj(std::move(rhs));
+  }
+
+  template <size_t Mf, size_t Af, bool Nf>
+  static_function& operator=(static_function<R(Args...), Mf, Af, Nf>&& rhs)
+      noexcept(nothrow_move) {
+    static_assert(element_max_size >= Mf,
+                  "assigned from too big static_function instance");
+    static_assert(element_max_align >= Af,
+                  "assigned from too aligned static_function instance");
+    static_assert(!nothrow_move || Nf,
+                  "assigned from static_function with throwing moves");
+
+    if (static_cast<const void*>(&rhs) != this) {
+      _release();
+      _transfer_obj(std::move(rhs));
+    }
+    return *this;
+  }
+
+  template <
+    class F,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<is_invocable_as<F>::value>::type* = nullptr >
+  static_function& operator=(F&& f) {
+    _release();
+    _emplace(std::forward<F>(f));
+    return *this;
+  }
+
+  static_function& operator=(nullptr_t) noexcept {
+    _release();
+    return *this;
+  }
+
+  /* Move-only like the closures it usually carries. */
+  static_function(const static_function&) = delete;
+  static_function& operator=(const static_function&) = delete;
+
+  ~static_function() {
+    _release();
+  }
+
+  explicit operator bool() const noexcept {
+    return lcm != nullptr;
+  }
+
+  R operator()(Args... args) const {
+    return invoke(&storage_obj, std::forward<Args>(args)...);
+  }
+};
+
+#endif /* STATIC_FUNCTION_HPP */
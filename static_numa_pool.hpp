@@ -0,0 +1,253 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_NUMA_POOL_HPP
+#define STATIC_NUMA_POOL_HPP
+
+#include <sys/mman.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <new>
+#include <utility>
+
+#include "static_pool.hpp"
+
+
+/* The NUMA node the calling thread runs on. Asking the kernel costs
+ * a syscall, so the answer is cached per thread and refreshed every
+ * static_numa_node_refresh calls - threads migrate rarely, and a stale
+ * answer costs just a remote slot, never correctness. Zero where NUMA
+ * isn't known. */
+constexpr unsigned static_numa_node_refresh = 256;
+
+inline unsigned static_numa_current_node() noexcept {
+#ifdef __linux__
+  static thread_local unsigned node = 0;
+  static thread_local unsigned calls = 0;
+  if (calls++ % static_numa_node_refresh == 0) {
+    unsigned cpu;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+      node = 0;
+    }
+  }
+  return node;
+#else
+  return 0;
+#endif
+}
+
+/* The number of NUMA nodes, i.e. the highest online one plus one. */
+inline size_t static_numa_node_count() noexcept {
+  size_t count = 1;
+#ifdef __linux__
+  /* The list has the form of e.g. "0-1" or "0,2-3". */
+  if (FILE* f = std::fopen("/sys/devices/system/node/online", "r")) {
+    unsigned lo, hi;
+    char sep;
+    while (std::fscanf(f, "%u", &lo) == 1) {
+      hi = lo;
+      if (std::fscanf(f, "%c", &sep) == 1 && sep == '-') {
+        if (std::fscanf(f, "%u", &hi) != 1) {
+          break;
+        }
+        std::fscanf(f, "%c", &sep);
+      }
+      count = std::max<size_t>(count, hi + 1);
+    }
+    std::fclose(f);
+  }
+#endif
+  return count;
+}
+
+/* Ask the kernel to back the memory with pages of the given node. That's
+ * a preference (MPOL_PREFERRED), not a binding: an exhausted node falls back
+ * to others instead of failing. False if the policy couldn't be set, e.g.
+ * in a kernel without NUMA. */
+inline bool static_numa_prefer_node(void* addr, size_t len,
+                                    unsigned node) noexcept {
+#ifdef __linux__
+  /* From <numaif.h>, which would bring a dependency on libnuma. */
+  constexpr int mpol_preferred = 1;
+  constexpr size_t mask_bits = 8 * sizeof(unsigned long);
+  if (node >= mask_bits) {
+    return false;
+  }
+  const unsigned long mask = 1ul << node;
+  /* The kernel reads maxnode - 1 bits of the mask. One less and node 63
+   * would get an empty mask, which MPOL_PREFERRED takes for "local". */
+  return syscall(SYS_mbind, addr, len, mpol_preferred, &mask,
+                 mask_bits + 1, 0) == 0;
+#else
+  (void)addr;
+  (void)len;
+  (void)node;
+  return false;
+#endif
+}
+
+
+/* static_numa_pool is a static_pool per NUMA node. Each one lives, together
+ * with its slab, in a region of memory placed on its node - slots, the
+ * free list and the magazines alike - so a product emplaced on the current
+ * node is node-local from creation through destruction: its handle gives
+ * the slot back to the pool it came from, whichever thread destroys it.
+ * The magazines of static_pool act as the thread-local front caches.
+ *
+ * emplace picks the pool of the calling thread's node and falls back to
+ * the following nodes only if it's exhausted.
+ * Handles are those of static_pool. Pass them between threads through
+ * static_move_ring rather than static_ring: the latter would move the
+ * product itself into its slots, away from the node.
+ *
+ * Up to MaxNodes nodes get a pool of their own; the ones above share them
+ * modulo the node count. The pool must outlive all its handles. */
+template <class Interface,
+          size_t MaxSize,
+          size_t MagazineSize = 16,
+          size_t MaxNodes = 8>
+class static_numa_pool {
+public:
+  typedef static_pool<Interface, MaxSize, MagazineSize> pool_type;
+  typedef typename pool_type::handle handle;
+  typedef typename pool_type::slot_type slot_type;
+  typedef Interface element_type;
+
+private:
+  /* The pool object comes first in a region, its slab follows. */
+  static constexpr size_t slab_offset =
+    static_ptr_round_up(sizeof(pool_type), pool_type::slot_align);
+
+  struct region {
+    void* addr = nullptr;
+    size_t len = 0;
+    bool local = false;
+
+    pool_type* pool() const noexcept {
+      return static_cast<pool_type*>(addr);
+    }
+  };
+
+  region regions[MaxNodes];
+  size_t nodes;
+
+  void _destroy() noexcept {
+    for (size_t i = 0; i < nodes; i++) {
+      if (regions[i].addr) {
+        regions[i].pool()->~pool_type();
+        munmap(regions[i].addr, regions[i].len);
+      }
+    }
+  }
+
+public:
+  /* Map capacity_per_node slots for every node. */
+  explicit static_numa_pool(size_t capacity_per_node)
+    : static_numa_pool(capacity_per_node, static_numa_node_count()) {
+  }
+
+  static_numa_pool(size_t capacity_per_node, size_t node_count)
+    : nodes(std::min(std::max<size_t>(node_count, 1), MaxNodes)) {
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t len = static_ptr_round_up(
+      slab_offset + pool_type::bytes_for(capacity_per_node), page);
+
+    for (size_t i = 0; i < nodes; i++) {
+      void* const addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (addr == MAP_FAILED) {
+        _destroy();
+        static_ptr_throw(std::bad_alloc());
+      }
+
+      /* The policy must be set before the first touch, which is what
+       * places the pages. */
+      regions[i].local =
+        static_numa_prefer_node(addr, len, static_cast<unsigned>(i));
+      regions[i].len = len;
+      new (addr) pool_type(static_cast<unsigned char*>(addr) + slab_offset,
+                           capacity_per_node);
+      regions[i].addr = addr;
+    }
+  }
+
+  static_numa_pool(const static_numa_pool&) = delete;
+  static_numa_pool& operator=(const static_numa_pool&) = delete;
+
+  ~static_numa_pool() {
+    _destroy();
+  }
+
+  size_t node_count() const noexcept {
+    return nodes;
+  }
+
+  /* Whether the memory of the node's pool has been placed on the node. */
+  bool is_node_local(size_t node) const noexcept {
+    return regions[node % nodes].local;
+  }
+
+  pool_type& pool_for(size_t node) noexcept {
+    return *regions[node % nodes].pool();
+  }
+
+  /* The node a handle's slot belongs to; node_count() for an empty or
+   * foreign handle. */
+  size_t node_of(const handle& h) const noexcept {
+    const unsigned char* const obj =
+      reinterpret_cast<const unsigned char*>(h.get());
+    for (size_t i = 0; obj && i < nodes; i++) {
+      const unsigned char* const begin =
+        static_cast<const unsigned char*>(regions[i].addr);
+      if (obj >= begin && obj < begin + regions[i].len) {
+        return i;
+      }
+    }
+    return nodes;
+  }
+
+  /* Construct a Te on the calling thread's node. The returned handle is
+   * empty if all pools are exhausted. */
+  template <class Te, class... Args>
+  handle emplace(Args&&... args) {
+    return emplace_on<Te>(static_numa_current_node(),
+                          std::forward<Args>(args)...);
+  }
+
+  /* Construct a Te on the given node, or - if its pool is exhausted - on
+   * the next one having a free slot. An exhausted pool doesn't touch args,
+   * so forwarding them again is fine. */
+  template <class Te, class... Args>
+  handle emplace_on(size_t node, Args&&... args) {
+    const size_t first = node % nodes;
+    for (size_t i = 0; i < nodes; i++) {
+      handle h = pool_for((first + i) % nodes).template emplace<Te>(
+        std::forward<Args>(args)...);
+      if (h) {
+        return h;
+      }
+    }
+    return handle();
+  }
+};
+
+#endif /* STATIC_NUMA_POOL_HPP */
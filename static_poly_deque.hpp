@@ -0,0 +1,194 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_POLY_DEQUE_HPP
+#define STATIC_POLY_DEQUE_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* static_poly_deque is an order-preserving, fixed-capacity double-ended
+ * queue of polymorphic products - the allocation-free replacement for
+ * linked structures built from nested static_ptrs (see "duda" in
+ * examples/experimental_usage.cpp). Slots are static_ptrs living inline in
+ * a ring; products are emplaced straight into them at either end, and
+ * removing one from either end is O(1).
+ *
+ * Products never move while in the deque, except with rotate and take_*,
+ * which relocate them (a memcpy for is_trivially_relocatable types).
+ * Capacity must be a power of two. */
+template <class Interface, size_t SlotBytes, size_t Capacity>
+class static_poly_deque {
+  static_assert(Capacity && (Capacity & (Capacity - 1)) == 0,
+                "static_poly_deque capacity must be a power of two");
+
+public:
+  typedef Interface element_type;
+  typedef static_ptr<Interface, SlotBytes> slot_type;
+  static constexpr size_t capacity = Capacity;
+
+private:
+  slot_type slots[Capacity];
+  size_t head = 0;
+  size_t count = 0;
+
+  slot_type& _slot(size_t i) noexcept {
+    return slots[(head + i) & (Capacity - 1)];
+  }
+
+  const slot_type& _slot(size_t i) const noexcept {
+    return slots[(head + i) & (Capacity - 1)];
+  }
+
+public:
+  static_poly_deque() = default;
+
+  static_poly_deque(const static_poly_deque&) = delete;
+  static_poly_deque& operator=(const static_poly_deque&) = delete;
+
+  ~static_poly_deque() {
+    clear();
+  }
+
+  /* Returns nullptr if the deque is full. */
+  template <class Te, class... Args>
+  Te* emplace_back(Args&&... args) {
+    if (count == Capacity) {
+      return nullptr;
+    }
+    Te& obj = _slot(count).template replace<Te>(std::forward<Args>(args)...);
+    count++;
+    return &obj;
+  }
+
+  template <class Te, class... Args>
+  Te* emplace_front(Args&&... args) {
+    if (count == Capacity) {
+      return nullptr;
+    }
+    slot_type& slot = slots[(head - 1) & (Capacity - 1)];
+    Te& obj = slot.template replace<Te>(std::forward<Args>(args)...);
+    head = (head - 1) & (Capacity - 1);
+    count++;
+    return &obj;
+  }
+
+  /* Destroy the product at the end. Return false if the deque is empty. */
+  bool pop_back() noexcept {
+    if (!count) {
+      return false;
+    }
+    _slot(--count).reset();
+    return true;
+  }
+
+  bool pop_front() noexcept {
+    if (!count) {
+      return false;
+    }
+    _slot(0).reset();
+    head = (head + 1) & (Capacity - 1);
+    count--;
+    return true;
+  }
+
+  /* Move the product at the end out. The deque mustn't be empty. */
+  slot_type take_back() {
+    slot_type out(std::move(_slot(count - 1)));
+    count--;
+    return out;
+  }
+
+  slot_type take_front() {
+    slot_type out(std::move(_slot(0)));
+    head = (head + 1) & (Capacity - 1);
+    count--;
+    return out;
+  }
+
+  /* Move the front product to the back. A full ring just advances its
+   * head; otherwise the product is relocated to the slot past the end. */
+  void rotate() {
+    if (count < 2) {
+      return;
+    }
+    if (count < Capacity) {
+      _slot(count) = std::move(_slot(0));
+    }
+    head = (head + 1) & (Capacity - 1);
+  }
+
+  /* The deque mustn't be empty. */
+  Interface& front() noexcept {
+    return *_slot(0);
+  }
+
+  const Interface& front() const noexcept {
+    return *_slot(0);
+  }
+
+  Interface& back() noexcept {
+    return *_slot(count - 1);
+  }
+
+  const Interface& back() const noexcept {
+    return *_slot(count - 1);
+  }
+
+  /* Counted from the front. */
+  Interface& operator[](size_t i) noexcept {
+    return *_slot(i);
+  }
+
+  const Interface& operator[](size_t i) const noexcept {
+    return *_slot(i);
+  }
+
+  size_t size() const noexcept {
+    return count;
+  }
+
+  bool empty() const noexcept {
+    return count == 0;
+  }
+
+  bool full() const noexcept {
+    return count == Capacity;
+  }
+
+  /* Destroy all products, the back one first - that's the order in which
+   * e.g. compensations of a chain should be undone. */
+  void clear() noexcept {
+    while (count) {
+      _slot(--count).reset();
+    }
+    head = 0;
+  }
+
+  /* Call f with Interface& of every product, from the front. */
+  template <class F>
+  void for_each(F&& f) const {
+    for (size_t i = 0; i < count; i++) {
+      f(*_slot(i));
+    }
+  }
+};
+
+#endif /* STATIC_POLY_DEQUE_HPP */
@@ -0,0 +1,286 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_POLY_VECTOR_HPP
+#define STATIC_POLY_VECTOR_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "static_ptr.hpp"
+
+
+/* static_poly_vector is a polymorphic container segregating its elements by
+ * concrete type - the idea of Boost.PolyCollection applied to the LCM
+ * infrastructure of static_ptr. Each concrete type gets its own contiguous
+ * segment with elements packed tightly by their real size, instead of
+ * MaxSize of static_ptr. Iterating segment by segment means calling the
+ * same implementation of a virtual method over and over, so the branch
+ * predictor is right nearly all the time. for_each<Te> goes further and
+ * removes the virtual dispatch entirely.
+ *
+ * Order of elements is preserved only within a segment. Growing a segment
+ * relocates its elements through the LCM (or memcpy for relocatable
+ * types). If a throwing move fails half-way, the segment is left intact. */
+template <class Interface>
+class static_poly_vector {
+public:
+  typedef Interface element_type;
+
+private:
+  struct segment {
+    const static_lcm* lcm;
+    /* Offset from the beginning of the concrete object to its Interface
+     * subobject. */
+    ptrdiff_t to_base;
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+
+    unsigned char* at(size_t i) const noexcept {
+      return data + i * lcm->obj_size;
+    }
+  };
+
+  std::vector<segment> segments;
+
+  template <class Te>
+  segment* _find() noexcept {
+    for (segment& seg : segments) {
+      if (seg.lcm->type_id == static_type_id<Te>::value) {
+        return &seg;
+      }
+    }
+    return nullptr;
+  }
+
+  /* Frees the new storage of a segment, along with the objects moved there
+   * so far, if growing fails half-way. */
+  struct grow_guard {
+    const static_lcm* const lcm;
+    unsigned char* data;
+    size_t size;
+
+    ~grow_guard() {
+      if (data) {
+        for (size_t i = size; i > 0; i--) {
+          lcm->delete_obj(data + (i - 1) * lcm->obj_size);
+        }
+        ::operator delete(data);
+      }
+    }
+  };
+
+  static void _grow(segment& seg) {
+    const size_t new_capacity = seg.capacity ? 2 * seg.capacity : 8;
+    unsigned char* const new_data = static_cast<unsigned char*>(
+      ::operator new(new_capacity * seg.lcm->obj_size));
+
+    if (seg.lcm->relocatable) {
+      if (seg.size) {
+        std::memcpy(new_data, seg.data, seg.size * seg.lcm->obj_size);
+      }
+    } else if (seg.lcm->nothrow_move) {
+      for (size_t i = 0; i < seg.size; i++) {
+        seg.lcm->move_obj(new_data + i * seg.lcm->obj_size, seg.at(i));
+        seg.lcm->delete_obj(seg.at(i));
+      }
+    } else {
+      /* A move may throw: the old objects are destroyed only once all of
+       * them have been moved, so a failure leaves the segment as it was. */
+      grow_guard guard { seg.lcm, new_data, 0 };
+      for (; guard.size < seg.size; guard.size++) {
+        seg.lcm->move_obj(new_data + guard.size * seg.lcm->obj_size,
+                          seg.at(guard.size));
+      }
+      _clear(seg);
+      seg.size = guard.size;
+      guard.data = nullptr;
+    }
+
+    ::operator delete(seg.data);
+    seg.data = new_data;
+    seg.capacity = new_capacity;
+  }
+
+  static void _clear(segment& seg) {
+    for (size_t i = seg.size; i > 0; i--) {
+      seg.lcm->delete_obj(seg.at(i - 1));
+    }
+    seg.size = 0;
+  }
+
+  void _destroy() {
+    for (segment& seg : segments) {
+      _clear(seg);
+      ::operator delete(seg.data);
+    }
+    segments.clear();
+  }
+
+  Interface& _base(const segment& seg, size_t i) const noexcept {
+    return *reinterpret_cast<Interface*>(seg.at(i) + seg.to_base);
+  }
+
+  template <class Te>
+  static static_ptr_span<Te> _span(const segment& seg) noexcept {
+    return static_ptr_span<Te>(seg.data, seg.size);
+  }
+
+  template <class... Types, class F>
+  static bool _invoke_typed(const segment& seg, F& f) {
+    return ((seg.lcm->type_id == static_type_id<Types>::value &&
+             (f(_span<Types>(seg)), true)) || ...);
+  }
+
+public:
+  static_poly_vector() = default;
+
+  static_poly_vector(static_poly_vector&& rhs) noexcept
+    : segments(std::move(rhs.segments)) {
+    rhs.segments.clear();
+  }
+
+  static_poly_vector& operator=(static_poly_vector&& rhs) noexcept {
+    if (&rhs != this) {
+      _destroy();
+      segments = std::move(rhs.segments);
+      rhs.segments.clear();
+    }
+    return *this;
+  }
+
+  static_poly_vector(const static_poly_vector&) = delete;
+  static_poly_vector& operator=(const static_poly_vector&) = delete;
+
+  ~static_poly_vector() {
+    _destroy();
+  }
+
+  /* Append a new Te to its segment. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  Te& emplace(Args&&... args) {
+    static_assert(alignof(Te) <= alignof(std::max_align_t),
+                  "emplaced over-aligned class");
+
+    segment* seg = _find<Te>();
+    if (!seg) {
+      segments.push_back(segment { &static_lcm_for<Te>::value, 0,
+                                   nullptr, 0, 0 });
+      seg = &segments.back();
+    }
+    if (seg->size == seg->capacity) {
+      _grow(*seg);
+    }
+
+    Te* const obj = new (seg->at(seg->size)) Te(std::forward<Args>(args)...);
+    if (seg->size++ == 0) {
+      seg->to_base = reinterpret_cast<unsigned char*>(
+                       static_cast<Interface*>(obj)) -
+                     reinterpret_cast<unsigned char*>(obj);
+    }
+    return *obj;
+  }
+
+  size_t size() const noexcept {
+    size_t total = 0;
+    for (const segment& seg : segments) {
+      total += seg.size;
+    }
+    return total;
+  }
+
+  bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  size_t segment_count() const noexcept {
+    return segments.size();
+  }
+
+  /* Destroy all elements but keep the memory of segments. */
+  void clear() {
+    for (segment& seg : segments) {
+      _clear(seg);
+    }
+  }
+
+  /* Call f with Interface& of every element, one segment at a time. */
+  template <class F>
+  void for_each(F&& f) const {
+    for (const segment& seg : segments) {
+      for (size_t i = 0; i < seg.size; i++) {
+        f(_base(seg, i));
+      }
+    }
+  }
+
+  /* Call f with Te& of every element of the Te's segment. The concrete type
+   * is known to the compiler, so there is no virtual dispatch. */
+  template <class Te, class F>
+  void for_each(F&& f) {
+    if (segment* const seg = _find<Te>()) {
+      Te* const first = reinterpret_cast<Te*>(seg->data);
+      for (size_t i = 0; i < seg->size; i++) {
+        f(first[i]);
+      }
+    }
+  }
+
+  /* The Te's segment as a contiguous span of Te; empty if there is none. */
+  template <class Te>
+  static_ptr_span<Te> span() noexcept {
+    segment* const seg = _find<Te>();
+    return seg ? _span<Te>(*seg) : static_ptr_span<Te>(nullptr, 0);
+  }
+
+  /* Call f once with the span of the Te's segment, unless it's empty.
+   * Working on the whole span rather than element by element lets the
+   * compiler vectorize field-wise loops. */
+  template <class Te, class F>
+  void for_each_typed(F&& f) {
+    const static_ptr_span<Te> elems = span<Te>();
+    if (!elems.empty()) {
+      f(elems);
+    }
+  }
+
+  /* Call f with static_ptr_span<Te> of every non-empty segment of one of
+   * Types, and with Interface& of every element of the other segments -
+   * e.g. a generic lambda covering the hot types plus a virtual fallback. */
+  template <class... Types, class F>
+  void bulk_invoke(F&& f) {
+    for (const segment& seg : segments) {
+      if (!seg.size || _invoke_typed<Types...>(seg, f)) {
+        continue;
+      }
+      for (size_t i = 0; i < seg.size; i++) {
+        f(_base(seg, i));
+      }
+    }
+  }
+};
+
+#endif /* STATIC_POLY_VECTOR_HPP */
@@ -0,0 +1,346 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_POOL_HPP
+#define STATIC_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* Each thread gets a process-wide, never reused number. static_pool uses it
+ * to pick the thread's magazine. */
+inline size_t static_pool_thread_index() noexcept {
+  static std::atomic<size_t> next_index { 0 };
+  static thread_local const size_t index = next_index++;
+  return index;
+}
+
+
+/* static_pool serves objects that must outlive a stack frame without
+ * touching malloc. It's a fixed-size slab of slots, each one being
+ * a static_ptr<Interface, MaxSize>, so everything static_ptr checks at
+ * compile-time (size, alignment, relationship) applies to the pool as well.
+ * Products are emplaced into a free slot and handed out via an owning,
+ * move-only handle with static_ptr-like interface. Destroying the handle
+ * destroys the product through its LCM and gives the slot back.
+ *
+ * Free slots are kept on a lock-free list (Treiber's stack with an ABA tag).
+ * To not make it a contention point, each thread has a magazine of up to
+ * MagazineSize free slots in front of it and goes to the shared list only to
+ * refill or flush the magazine in batches. Magazines are assigned by the
+ * static_pool_thread_index. Each one is guarded by a try-lock flag which
+ * its thread takes without contention in the common case. The flag lets
+ * threads sharing a magazine (see magazine_count) to fall back to the
+ * shared list, and an exhausted pool to drain magazines of other threads -
+ * including ones that have already exited.
+ *
+ * The pool must outlive all its handles. */
+template <class Interface, size_t MaxSize, size_t MagazineSize = 16>
+class static_pool {
+public:
+  typedef static_ptr<Interface, MaxSize> slot_type;
+  typedef Interface* pointer;
+  typedef Interface element_type;
+  static constexpr size_t magazine_count = 64;
+
+private:
+  static constexpr uint32_t npos = UINT32_MAX;
+
+  struct slot {
+    slot_type ptr;
+    std::atomic<uint32_t> next;
+  };
+
+  struct alignas(static_ptr_cacheline_size) magazine {
+    std::atomic<bool> locked { false };
+    uint32_t count = 0;
+    uint32_t items[MagazineSize];
+
+    bool try_lock() noexcept {
+      return !locked.load(std::memory_order_relaxed) &&
+             !locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+      locked.store(false, std::memory_order_release);
+    }
+  };
+
+public:
+  /* How much memory the caller-provided slab needs for the given number of
+   * slots. */
+  static constexpr size_t bytes_for(size_t capacity) {
+    return capacity * sizeof(slot);
+  }
+
+  static constexpr size_t slot_align = alignof(slot);
+
+  /* Slots are indexed with 32 bits, one value of which means "none". */
+  static constexpr size_t max_capacity = npos;
+
+  class handle {
+    friend class static_pool;
+
+    static_pool* pool = nullptr;
+    uint32_t index = npos;
+
+    handle(static_pool* pool, uint32_t index) noexcept
+      : pool(pool), index(index) {
+    }
+
+  public:
+    handle() noexcept = default;
+
+    handle(handle&& rhs) noexcept : pool(rhs.pool), index(rhs.index) {
+      rhs.pool = nullptr;
+      rhs.index = npos;
+    }
+
+    handle& operator=(handle&& rhs) noexcept {
+      if (&rhs != this) {
+        reset();
+        std::swap(pool, rhs.pool);
+        std::swap(index, rhs.index);
+      }
+      return *this;
+    }
+
+    handle(const handle&) = delete;
+    handle& operator=(const handle&) = delete;
+
+    ~handle() {
+      reset();
+    }
+
+    pointer operator->() const {
+      return get();
+    }
+
+    element_type& operator*() const {
+      return *get();
+    }
+
+    pointer get() const noexcept {
+      return pool ? pool->slots[index].ptr.get() : nullptr;
+    }
+
+    explicit operator bool() const noexcept {
+      return pool != nullptr;
+    }
+
+    void reset() {
+      if (pool) {
+        pool->_release(index);
+        pool = nullptr;
+        index = npos;
+      }
+    }
+  };
+
+private:
+  slot* slots;
+  const size_t slot_count;
+  const bool owns_slab;
+
+  static size_t _checked(size_t capacity) {
+    if (capacity > max_capacity) {
+      static_ptr_throw(std::length_error("static_pool capacity too big"));
+    }
+    return capacity;
+  }
+
+  /* Index of the top in the lower half, ABA tag in the upper one. */
+  alignas(static_ptr_cacheline_size) std::atomic<uint64_t> free_head;
+  magazine magazines[magazine_count];
+
+  void _init() {
+    for (size_t i = 0; i < slot_count; i++) {
+      slots[i].next.store(i + 1 < slot_count ? i + 1 : npos,
+                          std::memory_order_relaxed);
+    }
+    free_head.store(slot_count ? 0 : npos, std::memory_order_release);
+  }
+
+  uint32_t _pop_shared() {
+    uint64_t head = free_head.load(std::memory_order_acquire);
+    for (;;) {
+      const uint32_t index = static_cast<uint32_t>(head);
+      if (index == npos) {
+        return npos;
+      }
+      const uint64_t next = slots[index].next.load(std::memory_order_relaxed);
+      const uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+      if (free_head.compare_exchange_weak(head, new_head,
+                                          std::memory_order_acquire,
+                                          std::memory_order_acquire)) {
+        return index;
+      }
+    }
+  }
+
+  void _push_shared(uint32_t index) {
+    uint64_t head = free_head.load(std::memory_order_relaxed);
+    for (;;) {
+      slots[index].next.store(static_cast<uint32_t>(head),
+                              std::memory_order_relaxed);
+      const uint64_t new_head = (((head >> 32) + 1) << 32) | index;
+      if (free_head.compare_exchange_weak(head, new_head,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+
+  /* Returns the locked magazine of the calling thread or nullptr. */
+  magazine* _lock_magazine() noexcept {
+    magazine* const mag =
+      &magazines[static_pool_thread_index() % magazine_count];
+    return mag->try_lock() ? mag : nullptr;
+  }
+
+  /* The last resort when both own magazine and the shared list are empty. */
+  uint32_t _steal() {
+    for (magazine& mag : magazines) {
+      if (mag.try_lock()) {
+        const uint32_t index = mag.count ? mag.items[--mag.count] : npos;
+        mag.unlock();
+        if (index != npos) {
+          return index;
+        }
+      }
+    }
+    return npos;
+  }
+
+  uint32_t _acquire() {
+    magazine* const mag = _lock_magazine();
+    if (!mag) {
+      const uint32_t index = _pop_shared();
+      return index != npos ? index : _steal();
+    }
+
+    if (mag->count == 0) {
+      /* Refill a half of the magazine, so the next few releases don't need
+       * to flush immediately. */
+      while (mag->count < (MagazineSize + 1) / 2) {
+        const uint32_t index = _pop_shared();
+        if (index == npos) {
+          break;
+        }
+        mag->items[mag->count++] = index;
+      }
+    }
+
+    const uint32_t index = mag->count ? mag->items[--mag->count] : npos;
+    mag->unlock();
+    return index != npos ? index : _steal();
+  }
+
+  void _release(uint32_t index) {
+    slots[index].ptr.reset();
+
+    magazine* const mag = _lock_magazine();
+    if (!mag) {
+      _push_shared(index);
+      return;
+    }
+
+    if (mag->count == MagazineSize) {
+      while (mag->count > MagazineSize / 2) {
+        _push_shared(mag->items[--mag->count]);
+      }
+    }
+    mag->items[mag->count++] = index;
+    mag->unlock();
+  }
+
+public:
+  /* Allocate the slab for capacity slots. This is the only allocation the
+   * pool ever makes. A capacity above max_capacity throws
+   * std::length_error. */
+  explicit static_pool(size_t capacity)
+    : slots(new slot[_checked(capacity)]),
+      slot_count(capacity),
+      owns_slab(true) {
+    _init();
+  }
+
+  /* Use caller-provided slab of at least bytes_for(capacity) bytes aligned
+   * to slot_align. The capacity limit is the same. */
+  static_pool(void* slab, size_t capacity)
+    : slots(static_cast<slot*>(slab)),
+      slot_count(_checked(capacity)),
+      owns_slab(false) {
+    for (size_t i = 0; i < slot_count; i++) {
+      new (&slots[i]) slot();
+    }
+    _init();
+  }
+
+  static_pool(const static_pool&) = delete;
+  static_pool& operator=(const static_pool&) = delete;
+
+  ~static_pool() {
+    if (owns_slab) {
+      delete[] slots;
+    } else {
+      for (size_t i = 0; i < slot_count; i++) {
+        slots[i].~slot();
+      }
+    }
+  }
+
+  size_t capacity() const noexcept {
+    return slot_count;
+  }
+
+  /* Construct a Te in a free slot. The returned handle is empty if the pool
+   * is exhausted. */
+  template <class Te, class... Args>
+  handle emplace(Args&&... args) {
+    const uint32_t index = _acquire();
+    if (index == npos) {
+      return handle();
+    }
+
+    /* Give the slot back if the constructor throws. */
+    struct release_guard {
+      static_pool* pool;
+      uint32_t index;
+
+      ~release_guard() {
+        if (pool) {
+          pool->_release(index);
+        }
+      }
+    } guard { this, index };
+
+    slots[index].ptr.template emplace<Te>(std::forward<Args>(args)...);
+    guard.pool = nullptr;
+    return handle(this, index);
+  }
+};
+
+#endif /* STATIC_POOL_HPP */
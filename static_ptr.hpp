@@ -17,64 +17,504 @@
  *     Radoslaw Zarzynski <rzarzynski@mirantis.com>
  */
 
+#ifndef STATIC_PTR_HPP
+#define STATIC_PTR_HPP
+
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <type_traits>
 #include <tuple>
+#include <utility>
+
+#ifdef STATIC_PTR_STATS
+#include "static_ptr_stats.hpp"
+#endif
+
+
+/* Building with -fno-exceptions is detected automatically. Defining
+ * STATIC_PTR_NO_EXCEPTIONS forces that mode. There the library never
+ * throws; what would be an exception aborts instead. */
+#if !defined(STATIC_PTR_NO_EXCEPTIONS) && \
+    !defined(__cpp_exceptions) && !defined(__EXCEPTIONS)
+#define STATIC_PTR_NO_EXCEPTIONS
+#endif
+
+template <class E>
+[[noreturn]] void static_ptr_throw(const E& e) {
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+  (void)e;
+  std::abort();
+#else
+  throw e;
+#endif
+}
+
+/* The outcome of static_ptr::try_emplace and try_replace. */
+enum class static_ptr_status {
+  ok,
+  /* try_emplace on a non-empty static_ptr; nothing has been done. */
+  occupied,
+  /* The constructor has thrown; the static_ptr is left empty. */
+  failed,
+  /* static_shm_ptr only: the product's stable index is registered for
+   * another product in this process; nothing has been done. */
+  index_taken
+};
+
+
+/* static_type_id provides a cheap, RTTI-free identity for any type. Each
+ * instance of the template gets its own tag and the address of the tag
+ * is what we compare. */
+template <class T>
+struct static_type_id {
+  static constexpr char tag = 0;
+  static constexpr const void* value = &tag;
+};
+
+template <class T> constexpr char static_type_id<T>::tag;
+template <class T> constexpr const void* static_type_id<T>::value;
+
+
+/* is_trivially_relocatable tells whether moving an object to a new address
+ * and ending the lifetime of the source can be done with a plain memcpy.
+ * This holds for all trivially copyable types. Polymorphic products never
+ * are but most of them (everything not keeping pointers to itself) can be
+ * relocated bitwise anyway. Such types can opt in by specializing the trait:
+ *
+ *     template <>
+ *     struct is_trivially_relocatable<ConcreteA> : std::true_type {};
+ */
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+
+/* The life cycle manager for creation and deletion of objects that static_ptr
+ * stores. Although the deletion part allows us to not enforce element_type to
+ * have its destructor virtual (unlike the std::unique_ptr), the main
+ * motivation here are virtual constructors. The language doesn't offer them,
+ * but they are essential for the move-construct and move-assign operations.
+ * In contrast to std::unique_ptr and std::shared_ptr, static_ptr's lifetime
+ * is tied to lifetime of an object it has. In consequence, it's not enough to
+ * copy a pointer nor even memcpy the whole storage (this would be sufficient
+ * for PODs only). We need to properly move-construct a new instance each time
+ * someone does:
+ *
+ *     ptrA = std::move(ptrB);
+ *     // or
+ *     ptrC(std::move(ptrD);
+ *
+ * Moreover, static_ptr doesn't directly have information about exact types
+ * of the std::moved objects - they can be anything derived from element_type.
+ * We address this by having a table of plain function pointers for each
+ * concrete type (see static_lcm_for) and storing a pointer to it inside
+ * static_ptr. The table is constexpr, so it lives in read-only data and
+ * installing a LCM is nothing more than a pointer store.
+ *
+ * All operations take raw addresses of the storage. This way a single table
+ * serves every variant of static_ptr capable of holding the concrete type.
+ *
+ * TODO(rzarzynski): add support for externally-provided LCM implementation.
+ * This would allow for custom deleter. */
+struct static_lcm_cast;
+
+struct static_lcm {
+  void (*move_obj)(void* dst, void* src);
+  /* Optional; nullptr if the type isn't move-assignable. */
+  void (*assign_obj)(void* dst, void* src);
+  /* Optional; nullptr if the type isn't copy-constructible. */
+  void (*copy_obj)(void* dst, const void* src);
+  void (*delete_obj)(void* obj);
+  size_t obj_size;
+  size_t obj_align;
+  const void* type_id;
+  /* When set, move_obj followed by delete_obj can be replaced with
+   * a memcpy. */
+  bool relocatable;
+  /* When set, delete_obj does nothing and calling it can be skipped. */
+  bool trivially_destructible;
+  /* When set, move_obj never throws. */
+  bool nothrow_move;
+  /* Casts to the secondary interfaces (see static_ptr_interfaces). */
+  const static_lcm_cast* casts;
+  size_t cast_count;
+};
+
+/* One entry of the cross-cast table: the interface and how to get there
+ * from the beginning of the concrete object. */
+struct static_lcm_cast {
+  const void* type_id;
+  void* (*cast)(void* obj);
+};
+
+/* The secondary interfaces of a concrete type - the ones static_ptr_cast
+ * can switch to without dynamic_cast. Nothing is registered by default.
+ *
+ *     template <>
+ *     struct static_ptr_interfaces<ConcreteA>
+ *       : static_ptr_interface_list<Authorizer, Formatter> {};
+ */
+template <class... Interfaces>
+struct static_ptr_interface_list {
+  typedef static_ptr_interface_list type;
+};
+
+template <class Te>
+struct static_ptr_interfaces : static_ptr_interface_list<> {};
+
+/* The table is built when Te's LCM is, so each cast costs a scan over a few
+ * entries and a call doing the (ordinary, compile-time) static_cast. */
+template <class Te, class List = typename static_ptr_interfaces<Te>::type>
+struct static_lcm_casts;
+
+template <class Te, class... Interfaces>
+struct static_lcm_casts<Te, static_ptr_interface_list<Interfaces...>> {
+  template <class Other>
+  static void* cast(void* obj) {
+    return static_cast<Other*>(static_cast<Te*>(obj));
+  }
+
+  /* The sentinel is for the empty list; arrays can't have zero size. */
+  static constexpr static_lcm_cast table[] = {
+    { static_type_id<Interfaces>::value, &cast<Interfaces> }...,
+    { nullptr, nullptr }
+  };
+  static constexpr size_t count = sizeof...(Interfaces);
+};
+
+/* Move-assignment is an optional operation of LCM. Its lack forces static_ptr
+ * to destroy + move-construct even for objects of the same type. A throwing
+ * one is skipped as well, so a failed assignment never leaves a half-assigned
+ * object behind. */
+template <class Te, bool = std::is_nothrow_move_assignable<Te>::value>
+struct static_lcm_assign {
+  static void assign_obj(void* dst, void* src) {
+    *static_cast<Te*>(dst) = std::move(*static_cast<Te*>(src));
+  }
+
+  static constexpr void (*get())(void*, void*) {
+    return &assign_obj;
+  }
+};
+
+template <class Te>
+struct static_lcm_assign<Te, false> {
+  static constexpr void (*get())(void*, void*) {
+    return nullptr;
+  }
+};
+
+/* Copy-construction is optional too. Only static_value requires it. */
+template <class Te, bool = std::is_copy_constructible<Te>::value>
+struct static_lcm_copy {
+  static void copy_obj(void* dst, const void* src) {
+    new (dst) Te(*static_cast<const Te*>(src));
+  }
+
+  static constexpr void (*get())(void*, const void*) {
+    return &copy_obj;
+  }
+};
+
+template <class Te>
+struct static_lcm_copy<Te, false> {
+  static constexpr void (*get())(void*, const void*) {
+    return nullptr;
+  }
+};
+
+/* The LCM for the type Te. Each instance of this template receives its own
+ * table with info about the concrete Te deeply buried inside. That's the way
+ * how we support "virtual constructors" and call a proper destructor even if
+ * the interface hasn't declared its dtor as virtual. */
+template <class Te>
+struct static_lcm_for {
+  static void move_obj(void* dst, void* src) {
+    new (dst) Te(std::move(*static_cast<Te*>(src)));
+  }
+
+  static void delete_obj(void* obj) {
+    static_cast<Te*>(obj)->~Te();
+  }
+
+  static constexpr static_lcm value = {
+    &move_obj,
+    static_lcm_assign<Te>::get(),
+    static_lcm_copy<Te>::get(),
+    &delete_obj,
+    sizeof(Te),
+    alignof(Te),
+    static_type_id<Te>::value,
+    is_trivially_relocatable<Te>::value,
+    std::is_trivially_destructible<Te>::value,
+    std::is_nothrow_move_constructible<Te>::value,
+    static_lcm_casts<Te>::table,
+    static_lcm_casts<Te>::count
+  };
+};
+
+template <class Te> constexpr static_lcm static_lcm_for<Te>::value;
+
+
+/* static_ptr_access grants the building blocks sitting on top of static_ptr
+ * (see e.g. static_value) access to its storage and LCM. It isn't meant for
+ * regular users. */
+struct static_ptr_access {
+  template <class Ptr>
+  static void* storage(Ptr& ptr) noexcept {
+    return &ptr.storage_obj;
+  }
+
+  template <class Ptr>
+  static const static_lcm*& lcm(Ptr& ptr) noexcept {
+    return ptr.lcm;
+  }
+
+  template <class Ptr>
+  static const static_lcm* lcm(const Ptr& ptr) noexcept {
+    return ptr.lcm;
+  }
+};
+
+
+/* A run of n objects of the concrete type Te lying Stride bytes apart - what
+ * the typed bulk APIs (for_each_typed, bulk_invoke) hand out. The stride is
+ * a compile-time constant, so loops over a run can be unrolled and
+ * vectorized. With the default stride the objects are contiguous, and data()
+ * is a plain array of Te. */
+template <class Te, size_t Stride = sizeof(Te)>
+class static_ptr_span {
+  static_assert(Stride >= sizeof(Te), "static_ptr_span stride too small");
+
+  unsigned char* first;
+  size_t count;
+
+public:
+  typedef Te element_type;
+  static constexpr size_t stride = Stride;
+
+  class iterator {
+    unsigned char* pos;
+
+  public:
+    explicit iterator(unsigned char* pos) noexcept : pos(pos) {}
+
+    Te& operator*() const noexcept {
+      return *reinterpret_cast<Te*>(pos);
+    }
+
+    Te* operator->() const noexcept {
+      return reinterpret_cast<Te*>(pos);
+    }
+
+    iterator& operator++() noexcept {
+      pos += Stride;
+      return *this;
+    }
+
+    bool operator==(const iterator& rhs) const noexcept {
+      return pos == rhs.pos;
+    }
+
+    bool operator!=(const iterator& rhs) const noexcept {
+      return pos != rhs.pos;
+    }
+  };
+
+  static_ptr_span(void* first, size_t count) noexcept
+    : first(static_cast<unsigned char*>(first)), count(count) {
+  }
+
+  Te& operator[](size_t i) const noexcept {
+    return *reinterpret_cast<Te*>(first + i * Stride);
+  }
+
+  size_t size() const noexcept {
+    return count;
+  }
+
+  bool empty() const noexcept {
+    return count == 0;
+  }
+
+  iterator begin() const noexcept {
+    return iterator(first);
+  }
+
+  iterator end() const noexcept {
+    return iterator(first + count * Stride);
+  }
+
+  /* Only for contiguous runs. */
+  template <
+    size_t S = Stride,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<S == sizeof(Te)>::type* = nullptr >
+  Te* data() const noexcept {
+    return reinterpret_cast<Te*>(first);
+  }
+};
+
+
+/* Move the object (if any) from one storage to another, empty one. It backs
+ * moves between all variants of static_ptr and, as neither a template nor
+ * a member, is compiled once per translation unit instead of once per pair
+ * of variants. The storage holds the object at its very beginning, so the
+ * element type doesn't matter here. If the move throws, both sides are left
+ * as they were. */
+inline void static_ptr_transfer_obj(void* storage,
+                                    const static_lcm*& lcm,
+                                    void* rhs_storage,
+                                    const static_lcm*& rhs_lcm,
+                                    size_t rhs_storage_size) {
+  const static_lcm* const obj_lcm = rhs_lcm;
+  if (!obj_lcm) {
+    return;
+  }
+
+  if (obj_lcm->relocatable) {
+    /* The fast path. Copying the whole rhs storage, not just obj_size of it,
+     * gives the compiler a constant length to inline. */
+    std::memcpy(storage, rhs_storage, rhs_storage_size);
+    lcm = obj_lcm;
+    rhs_lcm = nullptr;
+    return;
+  }
+
+  obj_lcm->move_obj(storage, rhs_storage);
+  lcm = obj_lcm;
+
+  /* Using the already std::moved object is fully intensional. */
+  rhs_lcm = nullptr;
+  obj_lcm->delete_obj(rhs_storage);
+}
+
+
+/* Tells whether T is what make_static returns: a tuple led by a fake
+ * pointer carrying the concrete type. */
+template <class T>
+struct static_ptr_is_maker : std::false_type {};
+
+template <class T, class... Args>
+struct static_ptr_is_maker<std::tuple<T*, Args...>> : std::true_type {};
+
+
+/* Round the size up to the nearest multiple of the alignment. */
+constexpr size_t static_ptr_round_up(size_t size, size_t align) {
+  return (size + align - 1) / align * align;
+}
+
+
+/* The state of static_ptr: the storage and the LCM pointer. */
+template <size_t MaxSize, size_t Align>
+struct static_ptr_state {
+  typedef typename std::aligned_storage<MaxSize, Align>::type storage_t;
+
+  /* The emptiness is encoded in the LCM pointer: nullptr means there is no
+   * object in storage_obj. This spares us a separate flag and the padding
+   * that would come with it.
+   * The union is only to let the constructor be constexpr without touching
+   * the storage. */
+  union {
+    char no_obj;
+    mutable storage_t storage_obj;
+  };
+  const static_lcm* lcm;
+
+  /* NOTE: we won't zeroize or touch the storage in any other way as the only
+   * thing it could bring is an impact on performance. */
+  constexpr static_ptr_state() noexcept : no_obj(), lcm(nullptr) {}
+};
+
+/* The destructor of static_ptr lives here. Making it a separate layer lets
+ * static_ptr be trivially destructible when it's guaranteed to hold only
+ * trivially destructible objects. Ptr is the static_ptr itself; it's needed
+ * only to pick the right statistics record. */
+template <class Ptr, size_t MaxSize, size_t Align, bool TriviallyDestructible>
+struct static_ptr_storage : public static_ptr_state<MaxSize, Align> {
+  ~static_ptr_storage() {
+    if (this->lcm) {
+#ifdef STATIC_PTR_STATS
+      static_ptr_stats_for<Ptr>::get().destroyed();
+#endif
+      this->lcm->delete_obj(&this->storage_obj);
+    }
+  }
+};
+
+/* With STATIC_PTR_STATS the object's end still has to be counted, so the
+ * statistics mode gives up the triviality of the destructor. */
+template <class Ptr, size_t MaxSize, size_t Align>
+struct static_ptr_storage<Ptr, MaxSize, Align, true>
+  : public static_ptr_state<MaxSize, Align> {
+#ifdef STATIC_PTR_STATS
+  ~static_ptr_storage() {
+    if (this->lcm) {
+      static_ptr_stats_for<Ptr>::get().destroyed();
+    }
+  }
+#endif
+};
 
 
-template <class TypeT, size_t MaxSize>
-class static_ptr {
+/* The alignment of storage_obj is configurable. By default it is whatever
+ * std::aligned_storage picks for the given size. That might be too much for
+ * small products or too little for ones having alignas'ed members. Use
+ * maxalignof to match it exactly to the set of products.
+ *
+ * When TriviallyDestructible is set, static_ptr accepts only trivially
+ * destructible objects and becomes trivially destructible itself. Along with
+ * the constexpr default constructor this lets global and thread_local
+ * instances to be constant-initialized, and spares registering destructors
+ * (atexit, TLS init guards). See static_trivial_ptr. STATIC_PTR_STATS takes
+ * the triviality away, as the destruction is counted then.
+ *
+ * Moving a static_ptr moves the stored object, which may throw. When
+ * NothrowMove is set, static_ptr accepts only nothrow move constructible
+ * objects and its moves are noexcept, so e.g. std::vector relocates it
+ * without falling back to copies. See static_nothrow_ptr. */
+template <class TypeT,
+          size_t MaxSize,
+          size_t Align = alignof(typename std::aligned_storage<MaxSize>::type),
+          bool TriviallyDestructible = false,
+          bool NothrowMove = false>
+class static_ptr
+  : private static_ptr_storage<static_ptr<TypeT,
+                                          MaxSize,
+                                          Align,
+                                          TriviallyDestructible,
+                                          NothrowMove>,
+                               MaxSize,
+                               Align,
+                               TriviallyDestructible> {
   /* All variants of static_ptr are friends. */
-  template <class Tf, size_t Sf> friend class static_ptr;
+  template <class Tf, size_t Sf, size_t Af, bool Df, bool Nf>
+  friend class static_ptr;
+  friend struct static_ptr_access;
 public:
   /* Public typedefs and constants. */
   typedef TypeT* pointer;
   typedef TypeT element_type;
   static constexpr size_t element_max_size = MaxSize;
+  static constexpr size_t element_max_align = Align;
+  static constexpr bool trivially_destructible = TriviallyDestructible;
+  static constexpr bool nothrow_move = NothrowMove;
 
 private:
-  /* The life cycle manager interface for creation and deletion of objects that
-   * static_ptr stores. Although the deletion part allows us to not enforce
-   * element_type to have its destructor virtual (unlike the std::unique_ptr),
-   * the main motivation here are virtual constructors. The language doesn't
-   * offer them, but they are essential for the move-construct and move-assign
-   * operations.
-   * In contrast to std::unique_ptr and std::shared_ptr, static_ptr's lifetime
-   * is tied to lifetime of an object it has. In consequence, it's not enough to
-   * copy a pointer nor even memcpy the whole storage (this would be sufficient
-   * for PODs only). We need to properly move-construct a new instance each time
-   * someone does:
-   *
-   *     ptrA = std::move(ptrB);
-   *     // or
-   *     ptrC(std::move(ptrD);
-   *
-   * Moreover, static_ptr doesn't directly have information about exact types
-   * of the std::moved objects - they can be anything derived from element_type.
-   * We address this by constructing LCM for each concrete type (see _emplace)
-   * and storing it internally (usually very cheap as LCM needs a VPTR only).
-   *
-   * TODO(rzarzynski): add support for externally-provided LCM implementation.
-   * This would allow for custom deleter. */
-  struct LifeCycleManager {
-    virtual void clone_obj(void *, element_type&&) const = 0;
-    virtual void clone_lcm(void *) const = 0;
-
-    virtual void delete_obj(element_type&) const = 0;
-    /* TODO(rzarzynski): take care of LCM cleaning. */
-  };
+  typedef static_ptr_storage<static_ptr,
+                             MaxSize,
+                             Align,
+                             TriviallyDestructible> base_t;
+  typedef typename base_t::storage_t storage_t;
+  using base_t::storage_obj;
+  using base_t::lcm;
 
-  mutable typename std::aligned_storage<element_max_size>::type storage_obj;
-  typename std::aligned_storage<sizeof(LifeCycleManager)>::type storage_lcm;
-  bool is_empty = true;
-
-  const LifeCycleManager& get_lcm() noexcept {
-    return reinterpret_cast<const LifeCycleManager&>(storage_lcm);
-  }
-
-  /* In-place construct a new object of the Te type as well as a life cycle
+  /* In-place construct a new object of the Te type and install the life cycle
    * manager dedicated to this particular type. Forward all arguments to Te's
-   * constructor. Te must be compatible with the element_type. */
+   * constructor. Te must be compatible with the element_type. All ways of
+   * putting an object into static_ptr end here, so this is the right place
+   * for the compile-time checks of Te against the storage. */
   template <
     class Te,
     class... Args,
@@ -82,80 +522,120 @@ private:
     typename std::enable_if<
       std::is_base_of<element_type, Te>::value>::type* = nullptr >
   void _emplace(Args&&... args) {
-    /* Life cycle manager for the type Te. Due to nesting this class, each
-     * instance of the emplace template will receive its own LCM with info
-     * about the concrete Te deeply buried inside. That's the way how we
-     * support "virtual constructors" and call a proper destructor even if
-     * element_type hasn't declared its dtor as virtual. */
-    struct LCMe : public LifeCycleManager {
-      virtual void clone_obj(void* p, element_type&& u) const override {
-        new (p) Te(static_cast<Te&&>(u));
-      }
-
-      virtual void clone_lcm(void* p) const override {
-        new (p) LCMe;
-      }
-
-      virtual void delete_obj(element_type& t) const override {
-        static_cast<Te&>(t).~Te();
-      }
-    };
+    static_assert(element_max_size >= sizeof(Te),
+                  "emplaced too big class");
+    static_assert(element_max_align >= alignof(Te),
+                  "emplaced class is over-aligned for the storage");
+    static_assert(!trivially_destructible ||
+                    std::is_trivially_destructible<Te>::value,
+                  "emplaced non-trivially destructible class");
+    static_assert(!nothrow_move ||
+                    std::is_nothrow_move_constructible<Te>::value,
+                  "emplaced class with throwing move constructor");
 
-    /* The storage_lcm shouldn't store anything more than the VPTR. */
-    new (&storage_lcm) LCMe();
     new (&storage_obj) Te(std::forward<Args>(args)...);
-    is_empty = false;
+    lcm = &static_lcm_for<Te>::value;
+#ifdef STATIC_PTR_STATS
+    static_ptr_stats_for<static_ptr>::get().emplaced(sizeof(Te));
+#endif
   }
 
-  /* Helpers for make_obj. We need them only because std::apply will come in
-   * C++17. I know that they seem to be a black magic's spell. However, the idea
-   * is awfully simple: take a std::tuple<> and apply its elements as arguments
-   * to a function. It resembles Python's func(*[arg1, arg2, ...]). */
-  template<int ...> struct seq { };
+  /* Destroy the currently stored object if necessary. */
+  void _release() noexcept {
+    pointer this_obj_ptr = get();
+    if (this_obj_ptr) {
+      const static_lcm* const this_lcm = lcm;
+      lcm = nullptr;
+#ifdef STATIC_PTR_STATS
+      static_ptr_stats_for<static_ptr>::get().destroyed();
+#endif
+      if (!trivially_destructible) {
+        this_lcm->delete_obj(this_obj_ptr);
+      }
+    }
+  }
 
-  template<int N, int ...S>
-  struct gens : gens<N-1, N-1, S...> { };
+  /* Helpers for visit. The recursion walks the list of products and ends
+   * with the generic, virtual-dispatching call on element_type. */
+  template <class R, class F>
+  R _visit(F& f) const {
+    return f(*get());
+  }
 
-  template<int ...S>
-  struct gens<1, S...> {
-    typedef seq<S...> type;
-  };
+  template <class R, class F, class First, class... Rest>
+  R _visit(F& f) const {
+    static_assert(std::is_base_of<element_type, First>::value,
+                  "visiting with non-related class");
 
-  template<class Type, class Tuple, int ...S>
-  void _make_obj(Tuple&& tup, seq<S...>) {
-    _emplace<Type>(std::get<S>(tup) ...);
+    if (lcm->type_id == static_type_id<First>::value) {
+      return f(*reinterpret_cast<First*>(&storage_obj));
+    }
+    return _visit<R, F, Rest...>(f);
   }
 
-  template <class Tf, size_t Sf>
-  void _transfer_obj(static_ptr<Tf, Sf>&& rhs) {
-    typename static_ptr<Tf, Sf>::pointer rhs_obj_ptr = rhs.get();
+  /* Every pair of variants gets its own instance of this, so it's nothing
+   * more than a call of static_ptr_transfer_obj. */
+  template <class Tf, size_t Sf, size_t Af, bool Df, bool Nf>
+  void _transfer_obj(static_ptr<Tf, Sf, Af, Df, Nf>&& rhs)
+      noexcept(nothrow_move) {
+#ifdef STATIC_PTR_STATS
+    if (rhs.lcm) {
+      static_ptr_stats_for<static_ptr>::get().moved();
+      /* Each record must balance on its own: an object moving between
+       * variants leaves the source one and enters this one. */
+      if (!std::is_same<static_ptr,
+                        static_ptr<Tf, Sf, Af, Df, Nf>>::value) {
+        static_ptr_stats_for<static_ptr<Tf, Sf, Af, Df, Nf>>::get()
+          .destroyed();
+        static_ptr_stats_for<static_ptr>::get().emplaced(rhs.lcm->obj_size);
+      }
+    }
+#endif
+    static_ptr_transfer_obj(&storage_obj, lcm,
+                            &rhs.storage_obj, rhs.lcm,
+                            sizeof(rhs.storage_obj));
+  }
 
-    if (rhs_obj_ptr) {
-      rhs.get_lcm().clone_obj(&storage_obj, std::move(*rhs_obj_ptr));
-      rhs.get_lcm().clone_lcm(&storage_lcm);
+  /* Without exceptions every constructor is as good as nothrow. */
+  template <class Te, class... Args>
+  using _nothrow_tag = std::integral_constant<bool,
+#ifdef STATIC_PTR_NO_EXCEPTIONS
+    true
+#else
+    std::is_nothrow_constructible<Te, Args&&...>::value
+#endif
+  >;
 
-      /* Using the already std::moved rhs_obj_ptr is fully intensional. */
-      rhs.is_empty = true;
-      rhs.get_lcm().delete_obj(*rhs_obj_ptr);
+  template <class Te, class... Args>
+  static_ptr_status _try_emplace(std::true_type, Args&&... args) noexcept {
+    _emplace<Te>(std::forward<Args>(args)...);
+    return static_ptr_status::ok;
+  }
 
-      this->is_empty = false;
+  template <class Te, class... Args>
+  static_ptr_status _try_emplace(std::false_type, Args&&... args) noexcept {
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+    try {
+      _emplace<Te>(std::forward<Args>(args)...);
+    } catch (...) {
+      return static_ptr_status::failed;
     }
+#endif
+    return static_ptr_status::ok;
   }
 
 public:
-  /* All necessary things are initialized in the definitions. NOTE: we won't
-   * zeroize or touch the storage in any other way as the only thing it could
-   * bring is an impact on performance. */
-  static_ptr() noexcept = default;
+  /* All necessary things are initialized in static_ptr_state. */
+  constexpr static_ptr() noexcept = default;
 
   /* Constructor: the nullptr case. */
-  static_ptr(nullptr_t) noexcept : static_ptr() {};
+  constexpr static_ptr(nullptr_t) noexcept : static_ptr() {};
 
   /* Constructor: move from another instance of absolutely the same variant of
-   * static_ptr. In other words, rhs must be an instance
-   * of static_ptr<element_type, element_max_size). The constructor is present
-   * because of the Return Value Optimization.  */
-  static_ptr(static_ptr&& rhs) {
+   * static_ptr. In other words, rhs must be an instance of static_ptr with
+   * all the parameters the same. The constructor is present because of the
+   * Return Value Optimization.  */
+  static_ptr(static_ptr&& rhs) noexcept(nothrow_move) {
     _transfer_obj(std::move(rhs));
   }
 
@@ -163,12 +643,23 @@ public:
    * are compatible only if:
    *  1) a source one is smaller or equal in terms of available storage
    *     size than a destination one AND
-   *  2) a destination one encapsulates a type that stays in is_base_of
+   *  2) a source one doesn't have stricter alignment than a destination
+   *     one AND
+   *  3) a source one is trivially destructible if a destination one is
+   *     AND
+   *  4) a source one has nothrow moves if a destination one has AND
+   *  5) a destination one encapsulates a type that stays in is_base_of
    *     relationship with type stored by a source one. */
-  template <class Tf, size_t Sf>
-  static_ptr(static_ptr<Tf, Sf>&& rhs) {
+  template <class Tf, size_t Sf, size_t Af, bool Df, bool Nf>
+  static_ptr(static_ptr<Tf, Sf, Af, Df, Nf>&& rhs) noexcept(nothrow_move) {
     static_assert(element_max_size >= Sf,
                   "constructed from too big static_ptr instance");
+    static_assert(element_max_align >= Af,
+                  "constructed from too aligned static_ptr instance");
+    static_assert(!trivially_destructible || Df,
+                  "constructed from non-trivially destructible static_ptr");
+    static_assert(!nothrow_move || Nf,
+                  "constructed from static_ptr with throwing moves");
     static_assert(std::is_base_of<element_type, Tf>::value,
                   "constructed from non-related static_ptr instance");
 
@@ -176,9 +667,15 @@ public:
   }
 
   /* Constructor: the from-make_static case. */
-  template <class T>
+  template <
+    class T,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      static_ptr_is_maker<typename std::decay<T>::type>::value>::type*
+        = nullptr >
   static_ptr(T&& tup) {
-    using TypePtr = typename std::tuple_element<0, T>::type;
+    using TypePtr = typename std::tuple_element<0,
+      typename std::decay<T>::type>::type;
     using Type    = typename std::remove_pointer<TypePtr>::type;
 
     static_assert(element_max_size >= sizeof(Type),
@@ -186,29 +683,87 @@ public:
     static_assert(std::is_base_of<element_type, Type>::value,
                   "constructed from non-related class");
 
-    constexpr size_t tup_size = std::tuple_size<T>::value;
+    /* The leading fake pointer only carries the type. The rest go to Type's
+     * constructor. */
+    std::apply([this](TypePtr, auto&&... args) {
+      _emplace<Type>(std::forward<decltype(args)>(args)...);
+    }, std::forward<T>(tup));
+  }
 
-    _make_obj<Type>(std::move(tup), typename gens<tup_size>::type());
+  /* Constructor: construct Te in place, forwarding args to its constructor.
+   * There is no tuple in between. Moreover, since C++17 a prvalue returned
+   * from a function initializes the caller's object directly, so a factory
+   * templated on the destination builds the product exactly once, in its
+   * final storage - even when the caller wants a bigger variant of
+   * static_ptr than the factory would pick:
+   *
+   *     template <class Ptr = static_ptr<Interface,
+   *                                      maxsizeof<ConcreteA, ConcreteB>()>>
+   *     Ptr make_instance(bool first_one) {
+   *       if (first_one) {
+   *         return Ptr(std::in_place_type<ConcreteA>);
+   *       } else {
+   *         return Ptr(std::in_place_type<ConcreteB>, 3);
+   *       }
+   *     }
+   *
+   *     static_ptr<Interface, 128> ptr = make_instance<decltype(ptr)>(true);
+   */
+  template <class Te, class... Args>
+  explicit static_ptr(std::in_place_type_t<Te>, Args&&... args)
+      noexcept(std::is_nothrow_constructible<Te, Args&&...>::value) {
+    _emplace<Te>(std::forward<Args>(args)...);
   }
 
   /* Assignment: move from a compatible variant of static_ptr. For details
    * please refer to the documentation of the corresponding constructor. */
-  template <class Tf, size_t Sf>
-  static_ptr& operator=(static_ptr<Tf, Sf>&& rhs) {
+  template <class Tf, size_t Sf, size_t Af, bool Df, bool Nf>
+  static_ptr& operator=(static_ptr<Tf, Sf, Af, Df, Nf>&& rhs)
+      noexcept(nothrow_move) {
     static_assert(element_max_size >= Sf,
                   "assigned from too big static_ptr instance");
+    static_assert(element_max_align >= Af,
+                  "assigned from too aligned static_ptr instance");
+    static_assert(!trivially_destructible || Df,
+                  "assigned from non-trivially destructible static_ptr");
+    static_assert(!nothrow_move || Nf,
+                  "assigned from static_ptr with throwing moves");
     static_assert(std::is_base_of<element_type, Tf>::value,
                   "assigned from non-related static_ptr instance");
 
-    /* First, release (destroy) the currently stored object if necessary. */
-    pointer this_obj_ptr = this->get();
-    if (this_obj_ptr) {
-      this->is_empty = true;
-      this->get_lcm().delete_obj(*this_obj_ptr);
+    if (static_cast<const void*>(&rhs) == this) {
+      return *this;
+    }
+
+    /* Both sides hold objects of the same concrete type. Reuse what we
+     * already have through move-assignment instead of destroying it and
+     * constructing a new one. The rhs must end up empty anyway. */
+    if (this->lcm && rhs.lcm && this->lcm->type_id == rhs.lcm->type_id &&
+        this->lcm->assign_obj) {
+#ifdef STATIC_PTR_STATS
+      /* Counted as the destroy-and-construct path would be. */
+      static_ptr_stats_for<static_ptr>::get().destroyed();
+      static_ptr_stats_for<static_ptr>::get().moved();
+      if (!std::is_same<static_ptr,
+                        static_ptr<Tf, Sf, Af, Df, Nf>>::value) {
+        static_ptr_stats_for<static_ptr<Tf, Sf, Af, Df, Nf>>::get()
+          .destroyed();
+        static_ptr_stats_for<static_ptr>::get().emplaced(rhs.lcm->obj_size);
+      }
+#endif
+      const static_lcm* const rhs_lcm = rhs.lcm;
+      rhs_lcm->assign_obj(&storage_obj, &rhs.storage_obj);
+      rhs.lcm = nullptr;
+      rhs_lcm->delete_obj(&rhs.storage_obj);
+      return *this;
     }
 
+    /* First, release (destroy) the currently stored object if necessary. */
+    _release();
+
     /* Second, MoveConstruct a new object using our own storage but basing
-     * on the object hold by rhs. */
+     * on the object hold by rhs. Should that throw, we stay empty and rhs
+     * keeps its object. */
     _transfer_obj(std::move(rhs));
 
     return *this;
@@ -219,11 +774,9 @@ public:
   static_ptr(const static_ptr&) = delete;
   static_ptr& operator=(const static_ptr&) = delete;
 
-  ~static_ptr() {
-    auto obj = get();
-    if (obj) {
-      get_lcm().delete_obj(*obj);
-    }
+  /* Destroy the stored object (if any) and become empty. */
+  void reset() noexcept {
+    _release();
   }
 
   pointer operator->() const {
@@ -235,7 +788,14 @@ public:
   }
 
   pointer get() const noexcept {
-    return is_empty ? nullptr : reinterpret_cast<pointer>(&storage_obj);
+    /* The only overhead over the storage is the LCM pointer (plus padding
+     * imposed by the storage's alignment). */
+    static_assert(sizeof(static_ptr) ==
+                    static_ptr_round_up(sizeof(storage_t) + sizeof(void*),
+                                        alignof(static_ptr)),
+                  "static_ptr has unexpected overhead");
+
+    return lcm ? reinterpret_cast<pointer>(&storage_obj) : nullptr;
   }
 
   template <
@@ -244,12 +804,78 @@ public:
     /* Dummy template parameter solely for SFINAE. */
     typename std::enable_if<
       std::is_base_of<element_type, Te>::value>::type* = nullptr >
-  bool emplace(Args&&... args) {
-    /* The public emplace method can be called on empty static_pointer only. */
-    if (is_empty) {
+  bool emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<Te, Args&&...>::value) {
+    /* The public emplace method can be called on empty static_pointer only.
+     * NOTE: the result tells whether the pointer is empty afterwards, not
+     * whether it has succeeded. Prefer try_emplace. */
+    if (!lcm) {
       _emplace<Te>(std::forward<Args>(args)...);
     }
-    return is_empty;
+    return !lcm;
+  }
+
+  /* Like emplace but with a clear status and never throwing - a throwing
+   * constructor is reported as static_ptr_status::failed. For nothrow
+   * constructors there is no exception handling involved at all. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  static_ptr_status try_emplace(Args&&... args) noexcept {
+    if (lcm) {
+      return static_ptr_status::occupied;
+    }
+    return _try_emplace<Te>(_nothrow_tag<Te, Args...>(),
+                            std::forward<Args>(args)...);
+  }
+
+  /* try_emplace's counterpart of replace. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  static_ptr_status try_replace(Args&&... args) noexcept {
+    _release();
+    return _try_emplace<Te>(_nothrow_tag<Te, Args...>(),
+                            std::forward<Args>(args)...);
+  }
+
+  /* Closed-world dispatch. Call f with a reference to the stored object of
+   * its concrete type if it's one of the Products; otherwise (the product
+   * set isn't exhaustive) fall back to calling f with element_type&. This
+   * gives the compiler a chance to inline the hot methods as the virtual
+   * dispatch is replaced with a couple of compares:
+   *
+   *     ptr.visit<ConcreteA, ConcreteB>(
+   *       [](const Interface& i) { return i.get_name(); });
+   *
+   * Doing the call on a final Product (or with a qualified name) assures
+   * the devirtualization. The static_ptr mustn't be empty. Result type
+   * is deduced from the call with element_type&. */
+  template <class... Products, class F>
+  auto visit(F&& f) const -> decltype(f(std::declval<element_type&>())) {
+    typedef decltype(f(std::declval<element_type&>())) result_type;
+    return _visit<result_type, F, Products...>(f);
+  }
+
+  /* In contrast to emplace, replace works on non-empty static_ptr as well.
+   * The stored object is destroyed first. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  Te& replace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<Te, Args&&...>::value) {
+    _release();
+    _emplace<Te>(std::forward<Args>(args)...);
+    return *reinterpret_cast<Te*>(&storage_obj);
   }
 };
 
@@ -270,6 +896,133 @@ constexpr size_t maxsizeof() {
 }
 
 
+/* maxalignof is the maxsizeof's counterpart for alignment requirements. */
+template <class First>
+constexpr size_t maxalignof() {
+  return alignof(First);
+}
+
+template <class First, class Second, class... Tail>
+constexpr size_t maxalignof() {
+  return maxalignof<First>() > maxalignof<Second, Tail...>()
+                             ? maxalignof<First>()
+                             : maxalignof<Second, Tail...>();
+}
+
+
+/* static_ptr_slack is the number of bytes of Ptr's storage an instance of Te
+ * leaves unused. Comparing it across the products tells whether MaxSize is
+ * dictated by a single outlier. The optional MaxSlack turns it into
+ * a compile-time check, e.g. with an explicit instantiation:
+ *
+ *     template struct static_ptr_slack<Factory::pointer, ConcreteA, 16>;
+ */
+template <class Ptr,
+          class Te,
+          size_t MaxSlack = static_cast<size_t>(-1)>
+struct static_ptr_slack
+  : std::integral_constant<size_t, Ptr::element_max_size - sizeof(Te)> {
+  static_assert(Ptr::element_max_size >= sizeof(Te),
+                "class too big for the static_ptr");
+  static_assert(Ptr::element_max_size - sizeof(Te) <= MaxSlack,
+                "class wastes too much of the static_ptr's storage");
+};
+
+
+/* alltriviallydestructible tells whether none of its parameters needs its
+ * destructor to be run. */
+template <class First>
+constexpr bool alltriviallydestructible() {
+  return std::is_trivially_destructible<First>::value;
+}
+
+template <class First, class Second, class... Tail>
+constexpr bool alltriviallydestructible() {
+  return alltriviallydestructible<First>() &&
+         alltriviallydestructible<Second, Tail...>();
+}
+
+
+/* static_trivial_ptr is the variant of static_ptr for a set of products
+ * that are all trivially destructible. It's trivially destructible as well,
+ * so e.g. a global or thread_local one costs neither a static initializer
+ * nor a registered destructor:
+ *
+ *     thread_local static_trivial_ptr<Interface, ConcreteA, ConcreteB> cur;
+ */
+template <class Interface, class... Products>
+using static_trivial_ptr = static_ptr<Interface,
+                                      maxsizeof<Products...>(),
+                                      maxalignof<Products...>(),
+                                      true>;
+
+
+/* static_nothrow_ptr is the variant of static_ptr whose moves are noexcept.
+ * Products with a throwing move constructor are rejected at compile-time:
+ *
+ *     std::vector<static_nothrow_ptr<Interface, ConcreteA, ConcreteB>> v;
+ */
+template <class Interface, class... Products>
+using static_nothrow_ptr = static_ptr<Interface,
+                                      maxsizeof<Products...>(),
+                                      maxalignof<Products...>(),
+                                      false,
+                                      true>;
+
+
+/* Placing static_ptr instances side by side (e.g. in an array of per-thread
+ * workers) makes them share cache lines. cacheline_padded aligns and pads
+ * any variant of static_ptr to full cache lines, so neighbours can't
+ * false-share. */
+constexpr size_t static_ptr_cacheline_size = 64;
+
+template <class Ptr>
+struct alignas(static_ptr_cacheline_size) cacheline_padded : public Ptr {
+  using Ptr::Ptr;
+  using Ptr::operator=;
+
+  cacheline_padded() = default;
+  cacheline_padded(cacheline_padded&&) = default;
+  cacheline_padded& operator=(cacheline_padded&&) = default;
+};
+
+
+/* Cross-cast to a secondary interface of the stored object. The concrete
+ * type must have registered Other in static_ptr_interfaces; otherwise, as
+ * well as for an empty pointer, the result is nullptr. It's meant to
+ * replace dynamic_cast, which walks the type hierarchy:
+ *
+ *     if (Authorizer* auth = static_ptr_cast<Authorizer>(ptr)) { ... }
+ */
+template <class Other, class TypeT, size_t MaxSize, size_t Align, bool Df,
+          bool Nf>
+Other* static_ptr_cast(const static_ptr<TypeT, MaxSize, Align, Df, Nf>& ptr)
+    noexcept {
+  const static_lcm* const lcm = static_ptr_access::lcm(ptr);
+  if (lcm) {
+    for (size_t i = 0; i < lcm->cast_count; i++) {
+      if (lcm->casts[i].type_id == static_type_id<Other>::value) {
+        return static_cast<Other*>(
+          lcm->casts[i].cast(static_ptr_access::storage(
+            const_cast<static_ptr<TypeT, MaxSize, Align, Df, Nf>&>(ptr))));
+      }
+    }
+  }
+  return nullptr;
+}
+
+/* Downcast the caller knows to be correct, like std::static_pointer_cast.
+ * It's a plain static_cast - nothing is checked at runtime. */
+template <class Te, class TypeT, size_t MaxSize, size_t Align, bool Df,
+          bool Nf>
+Te* static_pointer_cast(const static_ptr<TypeT, MaxSize, Align, Df, Nf>& ptr)
+    noexcept {
+  static_assert(std::is_base_of<TypeT, Te>::value,
+                "casting to non-related class");
+  return static_cast<Te*>(ptr.get());
+}
+
+
 /* C++ doesn't allow to explicitly specify parameters for template constructor
  * of a class template. They can be deduced only. Because of the restriction we
  * need a helper function to construct an instance of a concrete type directly
@@ -291,3 +1044,5 @@ std::tuple<T*, Args...> make_static(Args&&... args)
   return std::forward_as_tuple(static_cast<T*>(nullptr),
                                std::forward<Args>(args)...);
 }
+
+#endif /* STATIC_PTR_HPP */
@@ -0,0 +1,262 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_PTR_ALGORITHM_HPP
+#define STATIC_PTR_ALGORITHM_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include "static_ptr.hpp"
+
+
+/* Bulk algorithms for contiguous ranges of static_ptr. Instead of one LCM
+ * call per element they work on runs of neighbours sharing the same LCM:
+ *  - runs of trivially destructible objects aren't destructed at all,
+ *  - runs of relocatable objects (and empty pointers) are moved with
+ *    a single memmove,
+ *  - the rest goes through the LCM element by element, but the loop
+ *    prefetches the elements ahead of the cursor. */
+
+/* How many elements ahead of the cursor are prefetched. */
+constexpr size_t static_ptr_prefetch_distance = 4;
+
+inline void static_ptr_prefetch(const void* addr) noexcept {
+#if defined(__GNUC__)
+  __builtin_prefetch(addr, 1 /* for write */);
+#else
+  (void)addr;
+#endif
+}
+
+/* Length of the run of elements sharing LCM with first. */
+template <class Ptr>
+size_t static_ptr_run_length(const Ptr* first, size_t n) noexcept {
+  const static_lcm* const lcm = static_ptr_access::lcm(*first);
+  size_t len = 1;
+  while (len < n && static_ptr_access::lcm(first[len]) == lcm) {
+    len++;
+  }
+  return len;
+}
+
+template <class Ptr>
+void static_ptr_prefetch_ahead(const Ptr* cursor, const Ptr* last) noexcept {
+  const Ptr* const ahead = cursor + static_ptr_prefetch_distance;
+  if (ahead < last) {
+    /* The object sits at the beginning, the LCM pointer at the end. */
+    static_ptr_prefetch(ahead);
+    static_ptr_prefetch(reinterpret_cast<const char*>(ahead + 1) - 1);
+  }
+}
+
+
+/* Destroy objects held by n pointers starting from first. The pointers stay
+ * alive but become empty. */
+template <class TypeT, size_t MaxSize, size_t Align, bool Trivial,
+          bool Nothrow>
+void destroy_n(static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* first,
+               size_t n) noexcept {
+  typedef static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow> ptr_t;
+
+  ptr_t* const last = first + n;
+  while (first != last) {
+    const static_lcm* const lcm = static_ptr_access::lcm(*first);
+    const size_t len = static_ptr_run_length(first, last - first);
+
+#ifdef STATIC_PTR_STATS
+    if (lcm) {
+      static_ptr_stats_for<ptr_t>::get().destroyed(len);
+    }
+#endif
+    if (!lcm) {
+      /* Nothing to do for empty ones. */
+    } else if (lcm->trivially_destructible) {
+      for (size_t i = 0; i < len; i++) {
+        static_ptr_access::lcm(first[i]) = nullptr;
+      }
+    } else {
+      for (size_t i = 0; i < len; i++) {
+        static_ptr_prefetch_ahead(first + i, last);
+        static_ptr_access::lcm(first[i]) = nullptr;
+        lcm->delete_obj(static_ptr_access::storage(first[i]));
+      }
+    }
+    first += len;
+  }
+}
+
+/* Move objects of n pointers starting from src to pointers starting from
+ * dst. Pointers of the source range become empty. Pointers of dst must be
+ * empty before the call. Ranges may overlap if dst precedes src. When
+ * raw_dst is set, dst isn't assumed to hold constructed static_ptrs;
+ * see uninitialized_move_n.
+ *
+ * Only the variants with NothrowMove set promise not to throw. Otherwise
+ * a throwing move leaves the objects before it moved and the rest at src;
+ * with raw_dst the pointers constructed at dst are destroyed, as
+ * std::uninitialized_move does. */
+template <class TypeT, size_t MaxSize, size_t Align, bool Trivial,
+          bool Nothrow>
+void static_ptr_relocate_n(
+    static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* src,
+    size_t n,
+    static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* dst,
+    bool raw_dst) noexcept(Nothrow) {
+  typedef static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow> ptr_t;
+
+  struct raw_guard {
+    ptr_t* const first;
+    ptr_t* const& cur;
+    bool armed;
+
+    ~raw_guard() {
+      if (armed) {
+        for (ptr_t* p = first; p != cur; p++) {
+          p->~ptr_t();
+        }
+      }
+    }
+  } guard { dst, dst, raw_dst && !Nothrow };
+
+  ptr_t* const last = src + n;
+  while (src != last) {
+    const static_lcm* const lcm = static_ptr_access::lcm(*src);
+    const size_t len = static_ptr_run_length(src, last - src);
+
+    if (!lcm || lcm->relocatable) {
+      /* The whole run, LCM pointers included, at once. Afterwards the
+       * source elements not overwritten by the destination are emptied. */
+#ifdef STATIC_PTR_STATS
+      if (lcm) {
+        static_ptr_stats_for<ptr_t>::get().moved(len);
+      }
+#endif
+      std::memmove(static_cast<void*>(dst), static_cast<const void*>(src),
+                   len * sizeof(ptr_t));
+      for (size_t i = 0; i < len; i++) {
+        if (src + i < dst || src + i >= dst + len) {
+          static_ptr_access::lcm(src[i]) = nullptr;
+        }
+      }
+      src += len;
+      dst += len;
+    } else {
+      for (ptr_t* const run_last = src + len; src != run_last; src++, dst++) {
+        static_ptr_prefetch_ahead(src, last);
+        if (raw_dst) {
+          new (dst) ptr_t(std::move(*src));
+        } else {
+          *dst = std::move(*src);
+        }
+      }
+    }
+  }
+  guard.armed = false;
+}
+
+/* Move objects between two ranges of live static_ptrs. See
+ * static_ptr_relocate_n for details. */
+template <class TypeT, size_t MaxSize, size_t Align, bool Trivial,
+          bool Nothrow>
+void relocate_n(static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* src,
+                size_t n,
+                static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* dst)
+    noexcept(Nothrow) {
+  static_ptr_relocate_n(src, n, dst, false);
+}
+
+/* Move-construct n static_ptrs in the uninitialized memory at dst from the
+ * ones at src. The source pointers become empty. The ranges mustn't
+ * overlap. Returns the end of the constructed range. */
+template <class TypeT, size_t MaxSize, size_t Align, bool Trivial,
+          bool Nothrow>
+static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* uninitialized_move_n(
+    static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* src,
+    size_t n,
+    static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* dst)
+    noexcept(Nothrow) {
+  static_ptr_relocate_n(src, n, dst, true);
+  return dst + n;
+}
+
+
+/* The run of n pointers starting from first as a span of their objects,
+ * spaced by the size of static_ptr. */
+template <class Te, class TypeT, size_t MaxSize, size_t Align, bool Trivial,
+          bool Nothrow>
+static_ptr_span<Te, sizeof(static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>)>
+static_ptr_run_span(static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* first,
+                    size_t n) noexcept {
+  typedef static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow> ptr_t;
+  return static_ptr_span<Te, sizeof(ptr_t)>(
+    static_ptr_access::storage(*first), n);
+}
+
+template <class... Types, class Ptr, class F>
+bool static_ptr_invoke_typed(const static_lcm* lcm, Ptr* first, size_t n,
+                             F& f) {
+  return ((lcm->type_id == static_type_id<Types>::value &&
+           (f(static_ptr_run_span<Types>(first, n)), true)) || ...);
+}
+
+/* Call f with a static_ptr_span<Te, sizeof(static_ptr)> of every run of
+ * neighbouring pointers holding exactly a Te. Ranges sorted or built by
+ * type (e.g. by a batch API) have few, long runs; the concrete type is
+ * known within them, so there's no virtual dispatch and field-wise loops
+ * over a run can be vectorized. */
+template <class Te, class F, class TypeT, size_t MaxSize, size_t Align,
+          bool Trivial, bool Nothrow>
+void for_each_typed(static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* first,
+                    size_t n,
+                    F&& f) {
+  typedef static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow> ptr_t;
+
+  ptr_t* const last = first + n;
+  while (first != last) {
+    const static_lcm* const lcm = static_ptr_access::lcm(*first);
+    const size_t len = static_ptr_run_length(first, last - first);
+    if (lcm && lcm->type_id == static_type_id<Te>::value) {
+      f(static_ptr_run_span<Te>(first, len));
+    }
+    first += len;
+  }
+}
+
+/* The same for all of Types at once: runs of them go to f as spans, other
+ * objects one by one as TypeT&. Empty pointers are skipped. */
+template <class... Types, class F, class TypeT, size_t MaxSize, size_t Align,
+          bool Trivial, bool Nothrow>
+void bulk_invoke(static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow>* first,
+                 size_t n,
+                 F&& f) {
+  typedef static_ptr<TypeT, MaxSize, Align, Trivial, Nothrow> ptr_t;
+
+  ptr_t* const last = first + n;
+  while (first != last) {
+    const static_lcm* const lcm = static_ptr_access::lcm(*first);
+    const size_t len = static_ptr_run_length(first, last - first);
+    if (lcm && !static_ptr_invoke_typed<Types...>(lcm, first, len, f)) {
+      for (size_t i = 0; i < len; i++) {
+        f(*first[i]);
+      }
+    }
+    first += len;
+  }
+}
+
+#endif /* STATIC_PTR_ALGORITHM_HPP */
@@ -0,0 +1,194 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_PTR_STATS_HPP
+#define STATIC_PTR_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+
+/* Runtime occupancy statistics of static_ptr. They're opt-in: define
+ * STATIC_PTR_STATS (consistently across the whole program) before including
+ * static_ptr.hpp, then call static_ptr_stats_dump() whenever you want to see
+ * how the storage is used. Every variant of static_ptr gets its own record;
+ * records register themselves at the first event.
+ *
+ * An object entering a variant's storage counts as an emplace there, one
+ * leaving it as a destroy - moves between different variants and copies of
+ * static_value included. Once all pointers are gone, emplaces and destroys
+ * of every record are equal. Moves count the transfers on top of that.
+ * To keep this true, trivially destructible variants (static_trivial_ptr)
+ * get a counting destructor in this mode, so they are no longer trivially
+ * destructible nor constant-initialized without a registered destructor.
+ *
+ * Counters are relaxed atomics, so the instrumentation is cheap but not
+ * free. Don't enable it where every cycle of emplace counts. */
+struct static_ptr_stats {
+  /* Bucket b counts objects of size in [2^(b-1), 2^b). The last bucket
+   * takes everything bigger as well. */
+  static constexpr size_t histogram_size = 16;
+
+  const char* const name;
+  const size_t max_size;
+  const size_t max_align;
+
+  std::atomic<uint64_t> emplaces { 0 };
+  std::atomic<uint64_t> moves { 0 };
+  std::atomic<uint64_t> destroys { 0 };
+  /* Objects that didn't fit and went elsewhere (see static_task). */
+  std::atomic<uint64_t> fallbacks { 0 };
+  std::atomic<uint64_t> emplaced_bytes { 0 };
+  std::atomic<size_t> largest { 0 };
+  std::atomic<uint64_t> histogram[histogram_size];
+
+  static_ptr_stats* next = nullptr;
+
+  static_ptr_stats(const char* name, size_t max_size, size_t max_align)
+    : name(name),
+      max_size(max_size),
+      max_align(max_align) {
+    for (auto& bucket : histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<static_ptr_stats*>& head = registry();
+    next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(next, this,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  static_ptr_stats(const static_ptr_stats&) = delete;
+  static_ptr_stats& operator=(const static_ptr_stats&) = delete;
+
+  static size_t bucket_of(size_t size) noexcept {
+    size_t bucket = 0;
+    while (size && bucket < histogram_size - 1) {
+      size >>= 1;
+      bucket++;
+    }
+    return bucket;
+  }
+
+  void emplaced(size_t size) noexcept {
+    emplaces.fetch_add(1, std::memory_order_relaxed);
+    emplaced_bytes.fetch_add(size, std::memory_order_relaxed);
+    histogram[bucket_of(size)].fetch_add(1, std::memory_order_relaxed);
+
+    size_t cur = largest.load(std::memory_order_relaxed);
+    while (cur < size &&
+           !largest.compare_exchange_weak(cur, size,
+                                          std::memory_order_relaxed)) {
+    }
+  }
+
+  void moved(size_t n = 1) noexcept {
+    moves.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  void destroyed(size_t n = 1) noexcept {
+    destroys.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  void fell_back() noexcept {
+    fallbacks.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /* The list of all records. A function-local static keeps it unique
+   * across translation units of this header-only library. */
+  static std::atomic<static_ptr_stats*>& registry() noexcept {
+    static std::atomic<static_ptr_stats*> head { nullptr };
+    return head;
+  }
+};
+
+
+/* The record of a particular variant of static_ptr (or of anything else
+ * exposing element_max_size and element_max_align). */
+template <class Ptr>
+struct static_ptr_stats_for {
+  static static_ptr_stats& get() noexcept {
+#if defined(__GNUC__)
+    /* The only portable-enough way to name Ptr without RTTI. */
+    static static_ptr_stats stats(__PRETTY_FUNCTION__,
+                                  Ptr::element_max_size,
+                                  Ptr::element_max_align);
+#else
+    static static_ptr_stats stats("static_ptr",
+                                  Ptr::element_max_size,
+                                  Ptr::element_max_align);
+#endif
+    return stats;
+  }
+};
+
+
+/* Call f(const static_ptr_stats&) for every registered record. */
+template <class F>
+void static_ptr_stats_for_each(F&& f) {
+  const static_ptr_stats* stats =
+    static_ptr_stats::registry().load(std::memory_order_acquire);
+  for (; stats; stats = stats->next) {
+    f(*stats);
+  }
+}
+
+/* Human-readable report. The average slack is the storage wasted by
+ * a typical object; a large one means MaxSize is chosen for an outlier. */
+inline void static_ptr_stats_dump(std::FILE* out = stderr) {
+  static_ptr_stats_for_each([out](const static_ptr_stats& stats) {
+    const uint64_t emplaces = stats.emplaces.load(std::memory_order_relaxed);
+    const uint64_t bytes = stats.emplaced_bytes.load(std::memory_order_relaxed);
+    const uint64_t average = emplaces ? bytes / emplaces : 0;
+
+    std::fprintf(out, "%s\n", stats.name);
+    std::fprintf(out,
+                 "  max_size=%zu max_align=%zu largest=%zu avg_slack=%llu\n",
+                 stats.max_size, stats.max_align,
+                 stats.largest.load(std::memory_order_relaxed),
+                 static_cast<unsigned long long>(
+                   emplaces ? stats.max_size - average : 0));
+    std::fprintf(out, "  emplaces=%llu moves=%llu destroys=%llu\n",
+                 static_cast<unsigned long long>(emplaces),
+                 static_cast<unsigned long long>(
+                   stats.moves.load(std::memory_order_relaxed)),
+                 static_cast<unsigned long long>(
+                   stats.destroys.load(std::memory_order_relaxed)));
+    const uint64_t fallbacks = stats.fallbacks.load(std::memory_order_relaxed);
+    if (fallbacks) {
+      std::fprintf(out, "  fallbacks=%llu\n",
+                   static_cast<unsigned long long>(fallbacks));
+    }
+    for (size_t b = 0; b < static_ptr_stats::histogram_size; b++) {
+      const uint64_t count = stats.histogram[b].load(std::memory_order_relaxed);
+      if (count && b == static_ptr_stats::histogram_size - 1) {
+        std::fprintf(out, "  size >= %zu: %llu\n",
+                     static_cast<size_t>(1) << (b - 1),
+                     static_cast<unsigned long long>(count));
+      } else if (count) {
+        std::fprintf(out, "  size < %zu: %llu\n",
+                     static_cast<size_t>(1) << b,
+                     static_cast<unsigned long long>(count));
+      }
+    }
+  });
+}
+
+#endif /* STATIC_PTR_STATS_HPP */
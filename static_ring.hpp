@@ -0,0 +1,257 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_RING_HPP
+#define STATIC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* Policies for static_ring. */
+struct static_ring_single_producer {};
+struct static_ring_multi_producer {};
+
+/* The index machinery shared by static_ring and static_move_ring. Slots are
+ * filled by put(Slot&) and emptied by take(Slot&); the callables decide how
+ * the objects get in and out. Capacity must be a power of two. */
+template <class Slot, size_t Capacity, class Producers>
+class static_ring_core;
+
+
+template <class Slot, size_t Capacity>
+class static_ring_core<Slot, Capacity, static_ring_single_producer> {
+  static_assert(Capacity && (Capacity & (Capacity - 1)) == 0,
+                "static_ring capacity must be a power of two");
+
+  alignas(static_ptr_cacheline_size) std::atomic<size_t> head { 0 };
+  alignas(static_ptr_cacheline_size) std::atomic<size_t> tail { 0 };
+  alignas(static_ptr_cacheline_size) Slot slots[Capacity];
+
+protected:
+  static_ring_core() = default;
+  static_ring_core(const static_ring_core&) = delete;
+  static_ring_core& operator=(const static_ring_core&) = delete;
+
+  template <class F>
+  bool _try_put(F&& put) {
+    const size_t t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+
+    put(slots[t & (Capacity - 1)]);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <class F>
+  bool _try_take(F&& take) {
+    const size_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    take(slots[h & (Capacity - 1)]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+public:
+  /* Exact only when called from the consumer or the producer thread
+   * while the other side is idle. */
+  size_t size_approx() const noexcept {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+};
+
+
+template <class Slot, size_t Capacity>
+class static_ring_core<Slot, Capacity, static_ring_multi_producer> {
+  static_assert(Capacity && (Capacity & (Capacity - 1)) == 0,
+                "static_ring capacity must be a power of two");
+
+  /* The sequence number of a slot says what it is waiting for. Equal to
+   * the position means free for a producer; position + 1 means ready for
+   * the consumer. */
+  struct slot {
+    std::atomic<size_t> seq;
+    Slot value;
+  };
+
+  /* Publishes the slot even if put throws. The consumer gets whatever
+   * the slot holds then - an empty static_ptr for static_ring. */
+  struct publish_guard {
+    slot& s;
+    size_t pos;
+
+    ~publish_guard() {
+      s.seq.store(pos + 1, std::memory_order_release);
+    }
+  };
+
+  alignas(static_ptr_cacheline_size) std::atomic<size_t> head { 0 };
+  alignas(static_ptr_cacheline_size) std::atomic<size_t> tail { 0 };
+  alignas(static_ptr_cacheline_size) slot slots[Capacity];
+
+protected:
+  static_ring_core() {
+    for (size_t i = 0; i < Capacity; i++) {
+      slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  static_ring_core(const static_ring_core&) = delete;
+  static_ring_core& operator=(const static_ring_core&) = delete;
+
+  /* Safe to call from many threads at once. */
+  template <class F>
+  bool _try_put(F&& put) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    slot* s;
+    for (;;) {
+      s = &slots[pos & (Capacity - 1)];
+      const size_t seq = s->seq.load(std::memory_order_acquire);
+      const ptrdiff_t diff = static_cast<ptrdiff_t>(seq - pos);
+      if (diff == 0) {
+        if (tail.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    publish_guard guard { *s, pos };
+    put(s->value);
+    return true;
+  }
+
+  template <class F>
+  bool _try_take(F&& take) {
+    const size_t pos = head.load(std::memory_order_relaxed);
+    slot& s = slots[pos & (Capacity - 1)];
+    if (s.seq.load(std::memory_order_acquire) != pos + 1) {
+      return false;
+    }
+
+    take(s.value);
+    s.seq.store(pos + Capacity, std::memory_order_release);
+    head.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+public:
+  size_t size_approx() const noexcept {
+    return tail.load(std::memory_order_acquire) -
+           head.load(std::memory_order_acquire);
+  }
+};
+
+
+/* static_ring is a bounded, lock-free queue for handing products over
+ * between threads without allocating. Slots are static_ptrs living inline
+ * in the ring: producers emplace directly into a free slot, consumers take
+ * the product by moving it out (which is a relocation for types marked with
+ * is_trivially_relocatable).
+ *
+ * There is always a single consumer. The number of producers is chosen with
+ * the Producers policy:
+ *  - static_ring_single_producer - a classic Lamport's ring; head and tail
+ *    are the only shared state,
+ *  - static_ring_multi_producer - producers claim slots with CAS on tail,
+ *    each slot carries a sequence number telling whether it's ready.
+ *
+ * Head and tail sit in separate cache lines. Capacity must be a power of
+ * two. */
+template <class Interface,
+          size_t MaxSize,
+          size_t Capacity,
+          class Producers = static_ring_single_producer>
+class static_ring
+  : public static_ring_core<static_ptr<Interface, MaxSize>,
+                            Capacity,
+                            Producers> {
+public:
+  typedef static_ptr<Interface, MaxSize> slot_type;
+  static constexpr size_t capacity = Capacity;
+
+  static_ring() = default;
+
+  /* Producer side. Returns false if the ring is full. */
+  template <class Te, class... Args>
+  bool try_emplace(Args&&... args) {
+    return this->_try_put([&](slot_type& slot) {
+      slot.template emplace<Te>(std::forward<Args>(args)...);
+    });
+  }
+
+  /* Consumer side. Returns false if the ring is empty. The out must be
+   * able to accommodate slot_type. */
+  template <class Ptr>
+  bool try_pop(Ptr& out) {
+    return this->_try_take([&](slot_type& slot) {
+      out = std::move(slot);
+    });
+  }
+};
+
+
+/* static_move_ring is static_ring for move-only objects which aren't
+ * products - the handles of static_pool and static_numa_pool above all.
+ * Only the handle travels, the product stays in its slot of the pool; with
+ * static_numa_pool that's the slab of the node it has been emplaced on.
+ * T must be default-constructible; a default-constructed T is what an
+ * empty slot holds. */
+template <class T,
+          size_t Capacity,
+          class Producers = static_ring_single_producer>
+class static_move_ring
+  : public static_ring_core<T, Capacity, Producers> {
+  static_assert(std::is_nothrow_move_assignable<T>::value,
+                "static_move_ring needs nothrow move-assignment");
+
+public:
+  typedef T slot_type;
+  static constexpr size_t capacity = Capacity;
+
+  static_move_ring() = default;
+
+  /* Producer side. Returns false if the ring is full; value is left
+   * untouched then. */
+  bool try_push(T&& value) noexcept {
+    return this->_try_put([&](T& slot) {
+      slot = std::move(value);
+    });
+  }
+
+  /* Consumer side. Returns false if the ring is empty. */
+  bool try_pop(T& out) noexcept {
+    return this->_try_take([&](T& slot) {
+      out = std::move(slot);
+    });
+  }
+};
+
+#endif /* STATIC_RING_HPP */
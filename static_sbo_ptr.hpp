@@ -0,0 +1,293 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_SBO_PTR_HPP
+#define STATIC_SBO_PTR_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* static_sbo_ptr is the small-buffer-optimized sibling of static_ptr. Objects
+ * up to MaxSize are stored inline exactly like in static_ptr. Bigger ones
+ * (and over-aligned ones) aren't a compilation error anymore but spill to
+ * memory obtained from Alloc. This lets to size MaxSize for the common case
+ * instead of the worst one.
+ *
+ * Whether an object lives inline is a property of its concrete type, so we
+ * don't need any flag for that: the LCM already knows the size. In the spilled
+ * case storage_obj keeps a pointer to the out-of-line object and moving
+ * static_sbo_ptr is a matter of stealing it.
+ *
+ * Alloc can be any allocator, including std::pmr::polymorphic_allocator.
+ * Memory is requested in units of std::max_align_t, so spilled objects can't
+ * be over-aligned. */
+template <class TypeT,
+          size_t MaxSize,
+          class Alloc = std::allocator<std::max_align_t>>
+class static_sbo_ptr
+  : private std::allocator_traits<Alloc>::template rebind_alloc<
+      std::max_align_t> {
+public:
+  /* Public typedefs and constants. */
+  typedef TypeT* pointer;
+  typedef TypeT element_type;
+  typedef typename std::allocator_traits<Alloc>::template rebind_alloc<
+    std::max_align_t> allocator_type;
+  static constexpr size_t element_max_size = MaxSize;
+
+private:
+  typedef std::allocator_traits<allocator_type> alloc_traits;
+  typedef typename std::aligned_storage<element_max_size>::type storage_t;
+
+  static_assert(element_max_size >= sizeof(void*),
+                "static_sbo_ptr needs space for a pointer to spilled object");
+
+  /* As in static_ptr, nullptr LCM means empty. */
+  mutable storage_t storage_obj;
+  const static_lcm* lcm = nullptr;
+
+  allocator_type& _alloc() noexcept {
+    return *this;
+  }
+
+  static constexpr bool _fits(size_t size, size_t align) {
+    return size <= sizeof(storage_t) && align <= alignof(storage_t);
+  }
+
+  bool _spilled() const noexcept {
+    return !_fits(lcm->obj_size, lcm->obj_align);
+  }
+
+  void*& _spilled_obj() const noexcept {
+    return *reinterpret_cast<void**>(&storage_obj);
+  }
+
+  void* _obj() const noexcept {
+    return _spilled() ? _spilled_obj() : static_cast<void*>(&storage_obj);
+  }
+
+  static size_t _units(size_t size) {
+    return (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+  }
+
+  void* _allocate(size_t size) {
+    return alloc_traits::allocate(_alloc(), _units(size));
+  }
+
+  void _deallocate(void* p, size_t size) {
+    alloc_traits::deallocate(_alloc(), static_cast<std::max_align_t*>(p),
+                             _units(size));
+  }
+
+  /* Gives the memory back if the constructor of a spilled object throws. */
+  struct allocation_guard {
+    static_sbo_ptr& owner;
+    void* p;
+    size_t size;
+
+    ~allocation_guard() {
+      if (p) {
+        owner._deallocate(p, size);
+      }
+    }
+  };
+
+  template <class Te, class... Args>
+  void _emplace(std::true_type /* fits */, Args&&... args) {
+    new (&storage_obj) Te(std::forward<Args>(args)...);
+    lcm = &static_lcm_for<Te>::value;
+  }
+
+  template <class Te, class... Args>
+  void _emplace(std::false_type /* fits */, Args&&... args) {
+    static_assert(alignof(Te) <= alignof(std::max_align_t),
+                  "spilled object can't be over-aligned");
+
+    allocation_guard guard { *this, _allocate(sizeof(Te)), sizeof(Te) };
+    new (guard.p) Te(std::forward<Args>(args)...);
+    _spilled_obj() = guard.p;
+    guard.p = nullptr;
+    lcm = &static_lcm_for<Te>::value;
+  }
+
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  void _emplace(Args&&... args) {
+    typedef std::integral_constant<bool, _fits(sizeof(Te), alignof(Te))> fits;
+    _emplace<Te>(fits(), std::forward<Args>(args)...);
+  }
+
+  void _release() {
+    if (lcm) {
+      const static_lcm* const this_lcm = lcm;
+      void* const obj = _obj();
+      const bool spilled = _spilled();
+
+      lcm = nullptr;
+      this_lcm->delete_obj(obj);
+      if (spilled) {
+        _deallocate(obj, this_lcm->obj_size);
+      }
+    }
+  }
+
+  void _propagate_alloc(std::true_type, static_sbo_ptr& rhs) {
+    _alloc() = std::move(rhs._alloc());
+  }
+
+  void _propagate_alloc(std::false_type, static_sbo_ptr&) {
+  }
+
+  /* The rhs must not be spilled or its memory must be deallocatable with
+   * our allocator. */
+  void _transfer_obj(static_sbo_ptr&& rhs) {
+    if (!rhs.lcm) {
+      return;
+    }
+
+    const static_lcm* const rhs_lcm = rhs.lcm;
+    if (rhs._spilled()) {
+      /* Just steal the pointer. */
+      _spilled_obj() = rhs._spilled_obj();
+    } else if (rhs_lcm->relocatable) {
+      std::memcpy(&storage_obj, &rhs.storage_obj, sizeof(storage_obj));
+    } else {
+      rhs_lcm->move_obj(&storage_obj, &rhs.storage_obj);
+      rhs_lcm->delete_obj(&rhs.storage_obj);
+    }
+    lcm = rhs_lcm;
+    rhs.lcm = nullptr;
+  }
+
+public:
+  static_sbo_ptr() noexcept = default;
+
+  static_sbo_ptr(nullptr_t) noexcept : static_sbo_ptr() {}
+
+  explicit static_sbo_ptr(const Alloc& alloc) noexcept
+    : allocator_type(alloc) {
+  }
+
+  /* Constructor: move. Spilled objects aren't moved at all, we take over
+   * the memory together with the allocator. */
+  static_sbo_ptr(static_sbo_ptr&& rhs)
+    : allocator_type(std::move(rhs._alloc())) {
+    _transfer_obj(std::move(rhs));
+  }
+
+  /* Assignment: move. If allocators differ and don't propagate, a spilled
+   * object must be move-constructed in memory from our allocator. */
+  static_sbo_ptr& operator=(static_sbo_ptr&& rhs) {
+    if (&rhs == this) {
+      return *this;
+    }
+
+    _release();
+
+    typedef typename alloc_traits::propagate_on_container_move_assignment
+      propagate;
+    if (propagate::value) {
+      _propagate_alloc(propagate(), rhs);
+    } else if (rhs.lcm && rhs._spilled() && !(_alloc() == rhs._alloc())) {
+      const static_lcm* const rhs_lcm = rhs.lcm;
+      void* const rhs_obj = rhs._spilled_obj();
+
+      allocation_guard guard { *this, _allocate(rhs_lcm->obj_size),
+                               rhs_lcm->obj_size };
+      rhs_lcm->move_obj(guard.p, rhs_obj);
+      _spilled_obj() = guard.p;
+      guard.p = nullptr;
+      lcm = rhs_lcm;
+
+      rhs._release();
+      return *this;
+    }
+
+    _transfer_obj(std::move(rhs));
+    return *this;
+  }
+
+  static_sbo_ptr(const static_sbo_ptr&) = delete;
+  static_sbo_ptr& operator=(const static_sbo_ptr&) = delete;
+
+  ~static_sbo_ptr() {
+    _release();
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return *this;
+  }
+
+  /* Tell whether the stored object lives outside of the inline storage. */
+  bool is_spilled() const noexcept {
+    return lcm && _spilled();
+  }
+
+  pointer operator->() const {
+    return get();
+  }
+
+  element_type& operator*() const {
+    return *get();
+  }
+
+  pointer get() const noexcept {
+    return lcm ? reinterpret_cast<pointer>(_obj()) : nullptr;
+  }
+
+  void reset() {
+    _release();
+  }
+
+  /* Mimics static_ptr::emplace, including the returned value. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  bool emplace(Args&&... args) {
+    if (!lcm) {
+      _emplace<Te>(std::forward<Args>(args)...);
+    }
+    return !lcm;
+  }
+
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  Te& replace(Args&&... args) {
+    _release();
+    _emplace<Te>(std::forward<Args>(args)...);
+    return *reinterpret_cast<Te*>(_obj());
+  }
+};
+
+#endif /* STATIC_SBO_PTR_HPP */
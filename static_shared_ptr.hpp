@@ -0,0 +1,304 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_SHARED_PTR_HPP
+#define STATIC_SHARED_PTR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* Policies for static_shared_ptr and static_shared_slot. */
+struct static_shared_atomic {};
+struct static_shared_local {};
+
+/* The reference counter. It's biased by one while the object is alive, so
+ * the slot stays busy until the destructor of the object finishes - not
+ * only until the last reference is dropped. Zero means the slot is free. */
+template <class Policy>
+struct static_shared_counter;
+
+template <>
+struct static_shared_counter<static_shared_atomic> {
+  std::atomic<size_t> value { 0 };
+
+  void open() noexcept {
+    value.store(2, std::memory_order_relaxed);
+  }
+  void acquire() noexcept {
+    value.fetch_add(1, std::memory_order_relaxed);
+  }
+  /* True if the last reference has been dropped. */
+  bool release() noexcept {
+    return value.fetch_sub(1, std::memory_order_acq_rel) == 2;
+  }
+  void close() noexcept {
+    value.store(0, std::memory_order_release);
+  }
+  size_t load() const noexcept {
+    return value.load(std::memory_order_acquire);
+  }
+};
+
+/* For objects that never leave a thread (e.g. a shard of a single-reactor
+ * server). No atomic instructions at all. */
+template <>
+struct static_shared_counter<static_shared_local> {
+  size_t value = 0;
+
+  void open() noexcept {
+    value = 2;
+  }
+  void acquire() noexcept {
+    value++;
+  }
+  bool release() noexcept {
+    return --value == 1;
+  }
+  void close() noexcept {
+    value = 0;
+  }
+  size_t load() const noexcept {
+    return value;
+  }
+};
+
+/* The part of static_shared_slot that static_shared_ptr knows about. The
+ * dispose thunk hides the slot's size and alignment. */
+template <class Policy>
+struct static_shared_control {
+  static_shared_counter<Policy> refs;
+  void (* const dispose)(static_shared_control*);
+
+  explicit static_shared_control(void (*dispose)(static_shared_control*))
+    : dispose(dispose) {
+  }
+};
+
+
+/* static_shared_ptr is a shared, reference-counting pointer to an object
+ * living in a static_shared_slot. There is no control block to allocate:
+ * the counter sits in the slot, next to the object. When the last pointer
+ * is gone, the object is destroyed through its LCM and the slot can be
+ * reused.
+ * Pointers share the Policy of their slot. static_shared_atomic ones may be
+ * copied and dropped from many threads concurrently, static_shared_local
+ * ones must stay within a single thread. */
+template <class TypeT, class Policy = static_shared_atomic>
+class static_shared_ptr {
+  template <class Tf, class Pf> friend class static_shared_ptr;
+  template <class Tf, size_t Sf, size_t Af, class Pf>
+  friend class static_shared_slot;
+
+public:
+  typedef TypeT* pointer;
+  typedef TypeT element_type;
+
+private:
+  typedef static_shared_control<Policy> control_t;
+
+  pointer obj = nullptr;
+  control_t* ctl = nullptr;
+
+  /* Adopts the reference already taken by the caller. */
+  static_shared_ptr(pointer obj, control_t* ctl) noexcept
+    : obj(obj),
+      ctl(ctl) {
+  }
+
+  void _release() noexcept {
+    control_t* const this_ctl = ctl;
+    obj = nullptr;
+    ctl = nullptr;
+    if (this_ctl && this_ctl->refs.release()) {
+      this_ctl->dispose(this_ctl);
+    }
+  }
+
+public:
+  static_shared_ptr() noexcept = default;
+
+  static_shared_ptr(nullptr_t) noexcept : static_shared_ptr() {}
+
+  static_shared_ptr(const static_shared_ptr& rhs) noexcept
+    : obj(rhs.obj),
+      ctl(rhs.ctl) {
+    if (ctl) {
+      ctl->refs.acquire();
+    }
+  }
+
+  static_shared_ptr(static_shared_ptr&& rhs) noexcept
+    : obj(rhs.obj),
+      ctl(rhs.ctl) {
+    rhs.obj = nullptr;
+    rhs.ctl = nullptr;
+  }
+
+  /* Constructors: from a pointer to a derived class. */
+  template <class Tf>
+  static_shared_ptr(const static_shared_ptr<Tf, Policy>& rhs) noexcept
+    : obj(rhs.obj),
+      ctl(rhs.ctl) {
+    static_assert(std::is_base_of<element_type, Tf>::value,
+                  "constructed from non-related static_shared_ptr instance");
+    if (ctl) {
+      ctl->refs.acquire();
+    }
+  }
+
+  template <class Tf>
+  static_shared_ptr(static_shared_ptr<Tf, Policy>&& rhs) noexcept
+    : obj(rhs.obj),
+      ctl(rhs.ctl) {
+    static_assert(std::is_base_of<element_type, Tf>::value,
+                  "constructed from non-related static_shared_ptr instance");
+    rhs.obj = nullptr;
+    rhs.ctl = nullptr;
+  }
+
+  ~static_shared_ptr() {
+    _release();
+  }
+
+  /* Copy-and-swap would cost an extra pair of counter operations. The copy
+   * is taken first, so self-assignment is safe. */
+  template <class Tf>
+  static_shared_ptr& operator=(const static_shared_ptr<Tf, Policy>& rhs)
+      noexcept {
+    static_shared_ptr copied(rhs);
+    return *this = std::move(copied);
+  }
+
+  static_shared_ptr& operator=(const static_shared_ptr& rhs) noexcept {
+    return operator=<TypeT>(rhs);
+  }
+
+  template <class Tf>
+  static_shared_ptr& operator=(static_shared_ptr<Tf, Policy>&& rhs) noexcept {
+    static_assert(std::is_base_of<element_type, Tf>::value,
+                  "assigned from non-related static_shared_ptr instance");
+    if (static_cast<void*>(this) != static_cast<void*>(&rhs)) {
+      /* Take over rhs before dropping the old object: that one may own
+       * rhs (think of a node holding the pointer to the next one). */
+      static_shared_ptr old(obj, ctl);
+      obj = rhs.obj;
+      ctl = rhs.ctl;
+      rhs.obj = nullptr;
+      rhs.ctl = nullptr;
+    }
+    return *this;
+  }
+
+  static_shared_ptr& operator=(static_shared_ptr&& rhs) noexcept {
+    return operator=<TypeT>(std::move(rhs));
+  }
+
+  static_shared_ptr& operator=(nullptr_t) noexcept {
+    _release();
+    return *this;
+  }
+
+  void reset() noexcept {
+    _release();
+  }
+
+  pointer get() const noexcept {
+    return obj;
+  }
+
+  pointer operator->() const noexcept {
+    return obj;
+  }
+
+  element_type& operator*() const noexcept {
+    return *obj;
+  }
+
+  explicit operator bool() const noexcept {
+    return obj != nullptr;
+  }
+
+  /* Exact for static_shared_local only. */
+  size_t use_count() const noexcept {
+    return ctl ? ctl->refs.load() - 1 : 0;
+  }
+};
+
+
+/* static_shared_slot is the fixed storage static_shared_ptrs point into.
+ * It may be a member, a global, an element of an array serving as a pool
+ * - anything that outlives the pointers made from it. The slot holds at
+ * most one object at a time; it becomes free again as soon as the last
+ * pointer to the object is gone. Slots are neither copyable nor movable -
+ * pointers refer to them.
+ *
+ *     static_shared_slot<Interface, maxsizeof<ConcreteA, ConcreteB>()> slot;
+ *     static_shared_ptr<Interface> op = slot.make<ConcreteA>(42);
+ *     static_shared_ptr<Interface> timer = op;
+ */
+template <class TypeT,
+          size_t MaxSize,
+          size_t Align = alignof(typename std::aligned_storage<MaxSize>::type),
+          class Policy = static_shared_atomic>
+class static_shared_slot : private static_shared_control<Policy> {
+public:
+  typedef static_shared_ptr<TypeT, Policy> pointer;
+  static constexpr size_t element_max_size = MaxSize;
+  static constexpr size_t element_max_align = Align;
+
+private:
+  typedef static_shared_control<Policy> control_t;
+
+  /* Destruction, the size and alignment checks - all is up to static_ptr
+   * and its LCM. */
+  static_ptr<TypeT, MaxSize, Align> obj;
+
+  static void _dispose(control_t* ctl) noexcept {
+    static_shared_slot* const slot = static_cast<static_shared_slot*>(ctl);
+    slot->obj.reset();
+    slot->refs.close();
+  }
+
+public:
+  static_shared_slot() noexcept : control_t(&_dispose) {}
+
+  static_shared_slot(const static_shared_slot&) = delete;
+  static_shared_slot& operator=(const static_shared_slot&) = delete;
+
+  /* Construct a Te in the slot and hand out the first pointer to it.
+   * Returns an empty pointer if the slot is still in use. Making objects
+   * in one slot from many threads at once isn't supported. */
+  template <class Te, class... Args>
+  pointer make(Args&&... args) {
+    if (in_use()) {
+      return pointer();
+    }
+    obj.template emplace<Te>(std::forward<Args>(args)...);
+    this->refs.open();
+    return pointer(obj.get(), this);
+  }
+
+  bool in_use() const noexcept {
+    return this->refs.load() != 0;
+  }
+};
+
+#endif /* STATIC_SHARED_PTR_HPP */
@@ -0,0 +1,275 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_SHM_PTR_HPP
+#define STATIC_SHM_PTR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* The stable identity of a product shared between processes. Unlike
+ * static_type_id (an address) or the LCM pointer (an address as well) it
+ * means the same in every process, so it has to be assigned by hand:
+ *
+ *     template <> struct static_shm_type_index<ConcreteA>
+ *       : std::integral_constant<uint32_t, 1> {};
+ *
+ * Zero is reserved for "empty"; indices must be below
+ * static_shm_max_types. */
+template <class Te>
+struct static_shm_type_index;
+
+constexpr uint32_t static_shm_max_types = 256;
+
+
+/* The per-process table translating stable indices to LCMs. Each process
+ * registers the products it's going to touch - also the ones it never
+ * emplaces, just consumes or destroys. Emplacing registers the product as
+ * a side effect. */
+class static_shm_registry {
+  static std::atomic<const static_lcm*>* table() noexcept {
+    static std::atomic<const static_lcm*> lcms[static_shm_max_types];
+    return lcms;
+  }
+
+public:
+  /* False if the index is already taken by another product. */
+  template <class Te>
+  static bool add() noexcept {
+    constexpr uint32_t index = static_shm_type_index<Te>::value;
+    static_assert(index != 0 && index < static_shm_max_types,
+                  "static_shm_type_index out of range");
+
+    const static_lcm* expected = nullptr;
+    const static_lcm* const lcm = &static_lcm_for<Te>::value;
+    return table()[index].compare_exchange_strong(expected, lcm,
+                                                  std::memory_order_acq_rel) ||
+           expected == lcm;
+  }
+
+  /* nullptr for indices nobody has registered. */
+  static const static_lcm* find(uint32_t index) noexcept {
+    return index < static_shm_max_types
+      ? table()[index].load(std::memory_order_acquire)
+      : nullptr;
+  }
+};
+
+
+/* static_shm_ptr is the variant of static_ptr whose representation means
+ * the same in every process: instead of the LCM pointer it keeps the stable
+ * index of the product. Such pointers may be placed in shared memory or an
+ * mmap'ed file and consumed in place by another process - zero-copy IPC for
+ * polymorphic messages.
+ *
+ * What static_shm_ptr can't fix is the object itself. Anything it points to
+ * with a raw pointer - and, above all, its vptr - is valid only in processes
+ * sharing the code layout: forked from a common parent or running the same
+ * non-PIE binary. Elsewhere don't call virtual methods of a consumed
+ * object; use visit (dispatch by the stable index, non-virtual calls on the
+ * concrete type) and products that keep no pointers.
+ * Moves and destruction go through the local registry, so they're safe in
+ * any process that has registered the product. */
+template <class TypeT,
+          size_t MaxSize,
+          size_t Align = alignof(typename std::aligned_storage<MaxSize>::type)>
+class static_shm_ptr {
+public:
+  /* Public typedefs and constants. */
+  typedef TypeT* pointer;
+  typedef TypeT element_type;
+  static constexpr size_t element_max_size = MaxSize;
+  static constexpr size_t element_max_align = Align;
+
+private:
+  typedef typename std::aligned_storage<element_max_size,
+                                        element_max_align>::type storage_t;
+
+  mutable storage_t storage_obj;
+  uint32_t index = 0;
+
+  /* Destroy the currently stored object if necessary. Without the product
+   * registered in this process the object is leaked rather than destroyed
+   * with an unknown destructor. */
+  void _release() noexcept {
+    const uint32_t this_index = index;
+    if (this_index) {
+      index = 0;
+      if (const static_lcm* const lcm = static_shm_registry::find(this_index)) {
+        lcm->delete_obj(&storage_obj);
+      }
+    }
+  }
+
+  void _transfer_obj(static_shm_ptr&& rhs) {
+    if (rhs.index) {
+      const static_lcm* const lcm = static_shm_registry::find(rhs.index);
+      if (!lcm || lcm->relocatable) {
+        std::memcpy(&storage_obj, &rhs.storage_obj, sizeof(storage_obj));
+      } else {
+        lcm->move_obj(&storage_obj, &rhs.storage_obj);
+        lcm->delete_obj(&rhs.storage_obj);
+      }
+      index = rhs.index;
+      rhs.index = 0;
+    }
+  }
+
+  template <class Te, class... Args>
+  void _emplace(Args&&... args) {
+    static_assert(element_max_size >= sizeof(Te),
+                  "emplaced too big class");
+    static_assert(element_max_align >= alignof(Te),
+                  "emplaced class is over-aligned for the storage");
+
+    new (&storage_obj) Te(std::forward<Args>(args)...);
+    index = static_shm_type_index<Te>::value;
+  }
+
+  template <class R, class F>
+  R _visit(F& f) const {
+    return f(*get());
+  }
+
+  template <class R, class F, class First, class... Rest>
+  R _visit(F& f) const {
+    static_assert(std::is_base_of<element_type, First>::value,
+                  "visiting with non-related class");
+
+    if (index == static_shm_type_index<First>::value) {
+      return f(*reinterpret_cast<First*>(&storage_obj));
+    }
+    return _visit<R, F, Rest...>(f);
+  }
+
+public:
+  static_shm_ptr() noexcept = default;
+
+  static_shm_ptr(nullptr_t) noexcept : static_shm_ptr() {}
+
+  static_shm_ptr(static_shm_ptr&& rhs) {
+    _transfer_obj(std::move(rhs));
+  }
+
+  static_shm_ptr& operator=(static_shm_ptr&& rhs) {
+    if (&rhs != this) {
+      _release();
+      _transfer_obj(std::move(rhs));
+    }
+    return *this;
+  }
+
+  static_shm_ptr(const static_shm_ptr&) = delete;
+  static_shm_ptr& operator=(const static_shm_ptr&) = delete;
+
+  ~static_shm_ptr() {
+    /* The layout is a part of the inter-process contract. */
+    static_assert(std::is_standard_layout<static_shm_ptr>::value,
+                  "static_shm_ptr must have the standard layout");
+    _release();
+  }
+
+  /* Mimics static_ptr::emplace, including the returned value: whether the
+   * pointer is empty afterwards - also when the product's index is taken
+   * by another product. Prefer try_emplace, which tells the cases apart. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  bool emplace(Args&&... args)
+      noexcept(std::is_nothrow_constructible<Te, Args&&...>::value) {
+    if (!index && static_shm_registry::add<Te>()) {
+      _emplace<Te>(std::forward<Args>(args)...);
+    }
+    return !index;
+  }
+
+  /* See static_ptr::try_emplace. A product whose index is registered for
+   * another one yields static_ptr_status::index_taken. */
+  template <
+    class Te,
+    class... Args,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      std::is_base_of<element_type, Te>::value>::type* = nullptr >
+  static_ptr_status try_emplace(Args&&... args) noexcept {
+    if (index) {
+      return static_ptr_status::occupied;
+    }
+    if (!static_shm_registry::add<Te>()) {
+      return static_ptr_status::index_taken;
+    }
+#ifndef STATIC_PTR_NO_EXCEPTIONS
+    try {
+      _emplace<Te>(std::forward<Args>(args)...);
+    } catch (...) {
+      return static_ptr_status::failed;
+    }
+#else
+    _emplace<Te>(std::forward<Args>(args)...);
+#endif
+    return static_ptr_status::ok;
+  }
+
+  void reset() noexcept {
+    _release();
+  }
+
+  /* Zero for empty pointers. */
+  uint32_t type_index() const noexcept {
+    return index;
+  }
+
+  pointer get() const noexcept {
+    return index ? reinterpret_cast<pointer>(&storage_obj) : nullptr;
+  }
+
+  pointer operator->() const noexcept {
+    return get();
+  }
+
+  element_type& operator*() const noexcept {
+    return *get();
+  }
+
+  /* The stored object if it's a Te, nullptr otherwise. */
+  template <class Te>
+  Te* get_as() const noexcept {
+    return index == static_shm_type_index<Te>::value
+      ? reinterpret_cast<Te*>(&storage_obj)
+      : nullptr;
+  }
+
+  /* Dispatch by the stable index, see static_ptr::visit. Unlike there, the
+   * fallback to element_type& involves the vptr - keep the product list
+   * exhaustive for objects made by other processes. */
+  template <class... Products, class F>
+  auto visit(F&& f) const -> decltype(f(std::declval<element_type&>())) {
+    typedef decltype(f(std::declval<element_type&>())) result_type;
+    return _visit<result_type, F, Products...>(f);
+  }
+};
+
+#endif /* STATIC_SHM_PTR_HPP */
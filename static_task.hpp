@@ -0,0 +1,385 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_TASK_HPP
+#define STATIC_TASK_HPP
+
+/* Unlike the rest of the library, this header needs C++20. */
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* The storage a static_task's coroutine frame is placed in. It's owned by
+ * the caller - exactly the static_ptr's idea - and passed to the coroutine
+ * as its first parameter (or the first one after the object for member
+ * coroutines):
+ *
+ *     static_task<int, 256> compute(static_task_frame<256>&, int x) {
+ *       co_return x * 2;
+ *     }
+ *
+ *     static_task_frame<256> frame;
+ *     auto task = compute(frame, 21);
+ *
+ * A frame holds one coroutine at a time. It must outlive the coroutine. */
+struct static_task_frame_base {
+  bool busy = false;
+};
+
+template <size_t FrameBytes>
+struct static_task_frame : public static_task_frame_base {
+  /* The header telling where the frame came from comes first. */
+  static constexpr size_t header_size = alignof(std::max_align_t);
+
+  alignas(std::max_align_t) unsigned char bytes[header_size + FrameBytes];
+
+  static_task_frame() = default;
+  static_task_frame(const static_task_frame&) = delete;
+  static_task_frame& operator=(const static_task_frame&) = delete;
+};
+
+
+/* The part of the promise dealing with the result. */
+template <class T>
+struct static_task_result {
+  std::optional<T> value;
+  std::exception_ptr error;
+
+  template <class U>
+  void return_value(U&& u) {
+    value.emplace(std::forward<U>(u));
+  }
+
+  T take() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return std::move(*value);
+  }
+};
+
+template <>
+struct static_task_result<void> {
+  std::exception_ptr error;
+
+  void return_void() noexcept {
+  }
+
+  void take() {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+};
+
+
+/* static_task is a lazy coroutine task whose frame is allocated in
+ * a static_task_frame instead of on the heap. The frame size is known to
+ * the compiler only, so it's checked at runtime. Frames bigger than
+ * FrameBytes, frames meeting a busy static_task_frame and frames of
+ * coroutines without one are allocated with Alloc instead. Such fallbacks
+ * are counted - see fallbacks() and, with STATIC_PTR_STATS,
+ * static_ptr_stats_dump().
+ *
+ * A stateful Alloc (e.g. std::pmr::polymorphic_allocator) is passed to the
+ * coroutine the way std::generator takes one - std::allocator_arg followed
+ * by the allocator, anywhere among the parameters:
+ *
+ *     static_task<int, 256, std::pmr::polymorphic_allocator<>>
+ *     compute(static_task_frame<256>&, std::allocator_arg_t,
+ *             std::pmr::polymorphic_allocator<> alloc, int x);
+ *
+ * A copy of it is kept in front of every fallback frame, for the
+ * deallocation. Coroutines without one use a default-constructed Alloc.
+ *
+ * A static_task is started by co_await-ing it (the awaiting coroutine is
+ * resumed when the task finishes) or, from regular code, with resume(). */
+template <class T,
+          size_t FrameBytes,
+          class Alloc = std::allocator<std::max_align_t>>
+class static_task {
+public:
+  static constexpr size_t element_max_size = FrameBytes;
+  static constexpr size_t element_max_align = alignof(std::max_align_t);
+
+  template <class... Params>
+  struct promise;
+
+private:
+  typedef static_task_frame<FrameBytes> frame_t;
+  typedef typename std::allocator_traits<Alloc>::template
+    rebind_alloc<std::max_align_t> alloc_t;
+  typedef std::allocator_traits<alloc_t> alloc_traits;
+
+  /* Placed right before the coroutine frame. nullptr means the frame has
+   * been allocated with Alloc. */
+  struct header {
+    static_task_frame_base* frame;
+  };
+  static_assert(sizeof(header) <= frame_t::header_size,
+                "static_task header doesn't fit the space for it");
+
+  static constexpr size_t header_size = frame_t::header_size;
+
+  /* Allocators that can't be recreated from nothing are kept in front of
+   * the header of fallback frames. */
+  static constexpr bool stores_alloc =
+    !alloc_traits::is_always_equal::value ||
+    !std::is_default_constructible<alloc_t>::value;
+  static constexpr size_t alloc_size = stores_alloc
+    ? static_ptr_round_up(sizeof(alloc_t), alignof(std::max_align_t))
+    : 0;
+  static_assert(alignof(alloc_t) <= alignof(std::max_align_t),
+                "static_task allocator is over-aligned");
+
+  /* The part of the promise common to all coroutine signatures. */
+  struct promise_base : public static_task_result<T> {
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+    void unhandled_exception() noexcept {
+      this->error = std::current_exception();
+    }
+  };
+
+  static std::atomic<size_t>& _fallbacks() noexcept {
+    static std::atomic<size_t> count { 0 };
+    return count;
+  }
+
+  static size_t _units(size_t size) noexcept {
+    return (alloc_size + header_size + size + sizeof(std::max_align_t) - 1) /
+           sizeof(std::max_align_t);
+  }
+
+  /* The frame is the first parameter of the coroutine or - for member
+   * coroutines - the first one after the object. */
+  static frame_t* _as_frame(frame_t& frame) noexcept {
+    return &frame;
+  }
+
+  template <class P>
+  static frame_t* _as_frame(P&) noexcept {
+    return nullptr;
+  }
+
+  template <class... Params>
+  static frame_t* _frame_of(Params&... params) noexcept {
+    frame_t* const frames[] = { _as_frame(params)..., nullptr, nullptr };
+    return frames[0] ? frames[0] : frames[1];
+  }
+
+  /* The allocator following std::allocator_arg, or the default one. */
+  static alloc_t _alloc_of() {
+    return alloc_t();
+  }
+
+  template <class A, class... Rest>
+  static alloc_t _alloc_after_tag(A& alloc, Rest&...) {
+    return alloc_t(alloc);
+  }
+
+  template <class First, class... Rest>
+  static alloc_t _alloc_of(First&, Rest&... rest) {
+    if constexpr (std::is_same<typename std::remove_cv<First>::type,
+                               std::allocator_arg_t>::value &&
+                  sizeof...(Rest) > 0) {
+      return _alloc_after_tag(rest...);
+    } else {
+      return _alloc_of(rest...);
+    }
+  }
+
+  template <class... Params>
+  static void* _allocate(size_t size, Params&... params) {
+    frame_t* const frame = _frame_of(params...);
+    unsigned char* raw;
+    if (frame && !frame->busy && size <= FrameBytes) {
+      frame->busy = true;
+      raw = frame->bytes;
+#ifdef STATIC_PTR_STATS
+      static_ptr_stats_for<static_task>::get().emplaced(size);
+#endif
+      new (raw) header { frame };
+    } else {
+      _fallbacks().fetch_add(1, std::memory_order_relaxed);
+#ifdef STATIC_PTR_STATS
+      static_ptr_stats_for<static_task>::get().fell_back();
+#endif
+      alloc_t alloc = _alloc_of(params...);
+      unsigned char* const base = reinterpret_cast<unsigned char*>(
+        alloc_traits::allocate(alloc, _units(size)));
+      if constexpr (stores_alloc) {
+        new (base) alloc_t(std::move(alloc));
+      }
+      raw = base + alloc_size;
+      new (raw) header { nullptr };
+    }
+    return raw + header_size;
+  }
+
+  static void _deallocate(void* ptr, size_t size) noexcept {
+    unsigned char* const raw = static_cast<unsigned char*>(ptr) - header_size;
+    static_task_frame_base* const frame =
+      reinterpret_cast<header*>(raw)->frame;
+    if (frame) {
+#ifdef STATIC_PTR_STATS
+      static_ptr_stats_for<static_task>::get().destroyed();
+#endif
+      frame->busy = false;
+      return;
+    }
+
+    unsigned char* const base = raw - alloc_size;
+    std::max_align_t* const units = reinterpret_cast<std::max_align_t*>(base);
+    if constexpr (stores_alloc) {
+      alloc_t* const stored = std::launder(reinterpret_cast<alloc_t*>(base));
+      alloc_t alloc(std::move(*stored));
+      stored->~alloc_t();
+      alloc_traits::deallocate(alloc, units, _units(size));
+    } else {
+      alloc_t alloc;
+      alloc_traits::deallocate(alloc, units, _units(size));
+    }
+  }
+
+  std::coroutine_handle<> coro;
+  promise_base* prom = nullptr;
+
+  static_task(std::coroutine_handle<> coro, promise_base* prom) noexcept
+    : coro(coro), prom(prom) {
+  }
+
+public:
+  /* The promise of a coroutine with the given parameters; see the
+   * specialization of std::coroutine_traits below. A promise per signature
+   * lets its operator new take exactly the coroutine's parameters without
+   * being a template. GCC pairs only a non-template operator new with the
+   * (necessarily non-template) operator delete; for a template one it
+   * reports -Wmismatched-new-delete in every coroutine. */
+  template <class... Params>
+  struct promise : public promise_base {
+    static_task get_return_object() noexcept {
+      return static_task(
+        std::coroutine_handle<promise>::from_promise(*this), this);
+    }
+
+    std::suspend_always initial_suspend() noexcept {
+      return {};
+    }
+
+    /* Resume whoever has been awaiting us - with symmetric transfer, so
+     * chains of tasks don't grow the stack. */
+    auto final_suspend() noexcept {
+      struct final_awaiter {
+        bool await_ready() noexcept {
+          return false;
+        }
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<promise> h) noexcept {
+          return h.promise().continuation;
+        }
+        void await_resume() noexcept {
+        }
+      };
+      return final_awaiter {};
+    }
+
+    static void* operator new(size_t size, Params&... params) {
+      return _allocate(size, params...);
+    }
+
+    static void operator delete(void* ptr, size_t size) noexcept {
+      _deallocate(ptr, size);
+    }
+  };
+
+  static_task(static_task&& rhs) noexcept
+    : coro(std::exchange(rhs.coro, nullptr)),
+      prom(std::exchange(rhs.prom, nullptr)) {
+  }
+
+  static_task& operator=(static_task&& rhs) noexcept {
+    if (&rhs != this) {
+      if (coro) {
+        coro.destroy();
+      }
+      coro = std::exchange(rhs.coro, nullptr);
+      prom = std::exchange(rhs.prom, nullptr);
+    }
+    return *this;
+  }
+
+  static_task(const static_task&) = delete;
+  static_task& operator=(const static_task&) = delete;
+
+  ~static_task() {
+    if (coro) {
+      coro.destroy();
+    }
+  }
+
+  bool done() const noexcept {
+    return !coro || coro.done();
+  }
+
+  /* Run the task from regular code until its first suspension point. */
+  void resume() {
+    coro.resume();
+  }
+
+  /* The result of a finished task. Rethrows what the coroutine has let
+   * out. */
+  T result() {
+    return prom->take();
+  }
+
+  bool await_ready() const noexcept {
+    return done();
+  }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+      noexcept {
+    prom->continuation = awaiting;
+    return coro;
+  }
+
+  T await_resume() {
+    return prom->take();
+  }
+
+  /* Frames that couldn't be placed in a static_task_frame so far. */
+  static size_t fallbacks() noexcept {
+    return _fallbacks().load(std::memory_order_relaxed);
+  }
+};
+
+/* Every coroutine returning static_task gets the promise for its own
+ * parameters (the object included, for member coroutines). */
+template <class T, size_t FrameBytes, class Alloc, class... Params>
+struct std::coroutine_traits<static_task<T, FrameBytes, Alloc>, Params...> {
+  typedef typename static_task<T, FrameBytes, Alloc>::template
+    promise<Params...> promise_type;
+};
+
+#endif /* STATIC_TASK_HPP */
@@ -0,0 +1,149 @@
+/*
+ * (C) Copyright 2026 The static_ptr contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATIC_VALUE_HPP
+#define STATIC_VALUE_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "static_ptr.hpp"
+
+
+/* static_value is the copyable flavour of static_ptr. It gives polymorphic
+ * value semantics: copying a static_value copy-constructs the concrete
+ * object straight into the destination's storage. No clone() returning
+ * std::unique_ptr, no allocation.
+ *
+ * The price is the products must be copy-constructible. This is enforced
+ * at compile-time when emplacing. NothrowMove works as the static_ptr's
+ * one. */
+template <class TypeT,
+          size_t MaxSize,
+          size_t Align = alignof(typename std::aligned_storage<MaxSize>::type),
+          bool NothrowMove = false>
+class static_value {
+public:
+  /* Public typedefs and constants. */
+  typedef TypeT* pointer;
+  typedef TypeT element_type;
+  static constexpr size_t element_max_size = MaxSize;
+  static constexpr size_t element_max_align = Align;
+  static constexpr bool nothrow_move = NothrowMove;
+
+private:
+  typedef static_ptr<TypeT, MaxSize, Align, false, NothrowMove> ptr_t;
+  ptr_t ptr;
+
+  void _copy_obj(const static_value& rhs) {
+    const static_lcm* const rhs_lcm = static_ptr_access::lcm(rhs.ptr);
+    if (rhs_lcm) {
+      rhs_lcm->copy_obj(static_ptr_access::storage(ptr),
+                        static_ptr_access::storage(rhs.ptr));
+      static_ptr_access::lcm(ptr) = rhs_lcm;
+#ifdef STATIC_PTR_STATS
+      static_ptr_stats_for<ptr_t>::get().emplaced(rhs_lcm->obj_size);
+#endif
+    }
+  }
+
+public:
+  static_value() noexcept = default;
+
+  static_value(nullptr_t) noexcept : static_value() {}
+
+  static_value(const static_value& rhs) {
+    _copy_obj(rhs);
+  }
+
+  static_value(static_value&& rhs) noexcept(nothrow_move)
+    : ptr(std::move(rhs.ptr)) {
+  }
+
+  /* Constructor: the from-make_static case. */
+  template <
+    class T,
+    /* Dummy template parameter solely for SFINAE. */
+    typename std::enable_if<
+      static_ptr_is_maker<typename std::decay<T>::type>::value>::type*
+        = nullptr >
+  static_value(T&& tup) : ptr(std::forward<T>(tup)) {
+    using TypePtr = typename std::tuple_element<0,
+      typename std::decay<T>::type>::type;
+    using Type    = typename std::remove_pointer<TypePtr>::type;
+
+    static_assert(std::is_copy_constructible<Type>::value,
+                  "constructed from non-copyable class");
+  }
+
+  /* Constructor: construct Te in place. See the static_ptr's counterpart. */
+  template <class Te, class... Args>
+  explicit static_value(std::in_place_type_t<Te> tag, Args&&... args)
+    : ptr(tag, std::forward<Args>(args)...) {
+    static_assert(std::is_copy_constructible<Te>::value,
+                  "constructed from non-copyable class");
+  }
+
+  static_value& operator=(const static_value& rhs) {
+    if (&rhs != this) {
+      ptr.reset();
+      _copy_obj(rhs);
+    }
+    return *this;
+  }
+
+  static_value& operator=(static_value&& rhs) noexcept(nothrow_move) {
+    ptr = std::move(rhs.ptr);
+    return *this;
+  }
+
+  pointer operator->() const {
+    return ptr.get();
+  }
+
+  element_type& operator*() const {
+    return *ptr.get();
+  }
+
+  pointer get() const noexcept {
+    return ptr.get();
+  }
+
+  void reset() noexcept {
+    ptr.reset();
+  }
+
+  /* Mimics static_ptr::emplace, including the returned value. */
+  template <class Te, class... Args>
+  bool emplace(Args&&... args) {
+    static_assert(std::is_copy_constructible<Te>::value,
+                  "emplaced non-copyable class");
+
+    return ptr.template emplace<Te>(std::forward<Args>(args)...);
+  }
+
+  template <class Te, class... Args>
+  Te& replace(Args&&... args) {
+    static_assert(std::is_copy_constructible<Te>::value,
+                  "replaced with non-copyable class");
+
+    return ptr.template replace<Te>(std::forward<Args>(args)...);
+  }
+};
+
+#endif /* STATIC_VALUE_HPP */